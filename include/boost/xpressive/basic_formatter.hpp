@@ -0,0 +1,629 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file basic_formatter.hpp
+/// Contains the definition of the basic_formatter\<\> class template and its
+/// associated helper functions.
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_XPRESSIVE_BASIC_FORMATTER_HPP_EAN_10_04_2005
+#define BOOST_XPRESSIVE_BASIC_FORMATTER_HPP_EAN_10_04_2005
+
+// MS compatible compilers support #pragma once
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+#include <vector>
+#include <climits>
+#include <iterator>
+#include <algorithm>
+#include <boost/assert.hpp>
+#include <boost/integer.hpp>
+#include <boost/mpl/assert.hpp>
+#include <boost/intrusive_ptr.hpp>
+#include <boost/numeric/conversion/converter.hpp>
+#include <boost/xpressive/regex_error.hpp>
+#include <boost/xpressive/regex_constants.hpp>
+#include <boost/xpressive/basic_regex.hpp>
+#include <boost/xpressive/match_results.hpp>
+#include <boost/xpressive/detail/detail_fwd.hpp>
+#include <boost/xpressive/detail/core/access.hpp>
+#include <boost/xpressive/detail/core/regex_impl.hpp>
+#include <boost/xpressive/detail/utility/literals.hpp>
+#include <boost/xpressive/detail/utility/algorithm.hpp>
+
+namespace boost { namespace xpressive
+{
+
+namespace detail
+{
+    ///////////////////////////////////////////////////////////////////////////////
+    // format_op
+    //   One step of a compiled format string.
+    struct format_op
+    {
+        enum kind_type
+        {
+            literal         // copy second_ characters from offset first_ of the literals
+          , sub_match       // copy sub-match first_, if second_ is 0 or it matched
+          , prefix          // copy the prefix
+          , suffix          // copy the suffix
+          , transform       // set_transform(out, transform_op(first_), transform_scope(second_))
+          , if_unmatched    // if sub-match first_ didn't match, go to op second_
+          , jump            // go to op second_
+        };
+
+        kind_type kind_;
+        std::size_t first_;
+        std::size_t second_;
+    };
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// basic_formatter
+//
+/// \brief Class template basic_formatter\<\> is a format string that has been
+/// parsed once, ahead of time, for use with the results of a particular regex.
+///
+/// A basic_formatter\<\> object is a formatter that can be passed to
+/// regex_replace() and match_results\<\>::format() in place of a format string.
+/// It produces the same output as the format string, but without parsing it
+/// again for each match. Back-references are checked, and named
+/// back-references are looked up, when the object is constructed.
+template<typename BidiIter>
+struct basic_formatter
+{
+    typedef BidiIter iterator_type;
+    typedef typename iterator_value<BidiIter>::type char_type;
+    typedef typename detail::string_type<char_type>::type string_type;
+    typedef regex_constants::match_flag_type flag_type;
+
+    /// \param rex   The regex whose results this formatter will format.
+    /// \param fmt   The format string.
+    /// \param flags Determines which format specifiers and escape sequences are
+    ///              recognized, as for match_results\<\>::format().
+    /// \pre         rex.regex_id() != 0
+    /// \throw       regex_error when fmt is not a valid format string for rex.
+    basic_formatter(basic_regex<BidiIter> const &rex, string_type const &fmt, flag_type flags = regex_constants::format_default)
+      : format_(fmt)
+      , flags_(flags)
+      , xpr_()
+      , traits_()
+      , case_converting_(false)
+      , literals_()
+      , ops_()
+      , named_marks_(0)
+      , max_(0)
+      , merge_(false)
+    {
+        this->compile_(rex);
+    }
+
+    /// \overload
+    ///
+    basic_formatter(basic_regex<BidiIter> const &rex, char_type const *fmt, flag_type flags = regex_constants::format_default)
+      : format_()
+      , flags_(flags)
+      , xpr_()
+      , traits_()
+      , case_converting_(false)
+      , literals_()
+      , ops_()
+      , named_marks_(0)
+      , max_(0)
+      , merge_(false)
+    {
+        for(; char_type() != *fmt; ++fmt)
+        {
+            this->format_.push_back(*fmt);
+        }
+        this->compile_(rex);
+    }
+
+    /// Writes the formatted result for what to out. If what holds the results of
+    /// a different regex, the format string is parsed as match_results\<\>::format()
+    /// would parse it.
+    ///
+    /// \param what The results of a match.
+    /// \param out  The output iterator to write to.
+    /// \return     The output iterator after the last character written.
+    template<typename OutputIterator>
+    OutputIterator operator ()(match_results<BidiIter> const &what, OutputIterator out, flag_type) const
+    {
+        if(what.regex_id() != this->xpr_.get())
+        {
+            return what.format(out, this->format_, this->flags_);
+        }
+        else if(this->case_converting_)
+        {
+            detail::case_converting_iterator<OutputIterator, char_type> iout(out, this->traits_.get());
+            return this->format_ops_(what, iout).base();
+        }
+
+        return this->format_ops_(what, out);
+    }
+
+    /// Returns the format string.
+    ///
+    string_type const &str() const
+    {
+        return this->format_;
+    }
+
+    /// Returns the flags the format string was parsed with.
+    ///
+    flag_type flags() const
+    {
+        return this->flags_;
+    }
+
+private:
+    /// INTERNAL ONLY
+    typedef typename string_type::const_iterator iterator;
+    typedef detail::format_op format_op;
+
+    /// INTERNAL ONLY
+    void compile_(basic_regex<BidiIter> const &rex)
+    {
+        BOOST_ASSERT(0 != rex.regex_id());
+        detail::regex_impl<BidiIter> const &impl = detail::core_access<BidiIter>::get_regex_impl_ref(rex);
+        this->xpr_ = impl.xpr_;
+        this->traits_ = impl.traits_;
+        this->named_marks_ = impl.named_marks_.get();
+        this->max_ = static_cast<int>(impl.mark_count_);
+
+        iterator cur = this->format_.begin(), end = this->format_.end();
+        if(0 != (regex_constants::format_literal & this->flags_))
+        {
+            for(; cur != end; ++cur)
+            {
+                this->literal_(*cur);
+            }
+        }
+        else if(0 != (regex_constants::format_perl & this->flags_))
+        {
+            this->case_converting_ = true;
+            this->compile_perl_(cur, end);
+        }
+        else if(0 != (regex_constants::format_sed & this->flags_))
+        {
+            this->compile_sed_(cur, end);
+        }
+        else if(0 != (regex_constants::format_all & this->flags_))
+        {
+            this->case_converting_ = true;
+            this->compile_all_(cur, end);
+            BOOST_XPR_ENSURE_(cur == end
+              , regex_constants::error_paren, "unbalanced parentheses in format string");
+        }
+        else
+        {
+            this->compile_ecma_262_(cur, end);
+        }
+
+        // only needed while compiling
+        this->named_marks_ = 0;
+    }
+
+    /// INTERNAL ONLY
+    void literal_(char_type ch)
+    {
+        if(this->merge_)
+        {
+            ++this->ops_.back().second_;
+        }
+        else
+        {
+            this->op_(format_op::literal, this->literals_.size(), 1);
+            this->merge_ = true;
+        }
+        this->literals_.push_back(ch);
+    }
+
+    /// INTERNAL ONLY
+    std::size_t op_(format_op::kind_type kind, std::size_t first = 0, std::size_t second = 0)
+    {
+        format_op op = {kind, first, second};
+        this->ops_.push_back(op);
+        this->merge_ = false;
+        return this->ops_.size() - 1;
+    }
+
+    /// INTERNAL ONLY
+    // the index of the next op, which is the target of a jump
+    std::size_t label_()
+    {
+        this->merge_ = false;
+        return this->ops_.size();
+    }
+
+    /// INTERNAL ONLY
+    void compile_ecma_262_(iterator cur, iterator end)
+    {
+        while(cur != end)
+        {
+            if(BOOST_XPR_CHAR_(char_type, '$') == *cur)
+            {
+                this->compile_backref_(++cur, end);
+            }
+            else
+            {
+                this->literal_(*cur++);
+            }
+        }
+    }
+
+    /// INTERNAL ONLY
+    void compile_sed_(iterator cur, iterator end)
+    {
+        while(cur != end)
+        {
+            switch(*cur)
+            {
+            case BOOST_XPR_CHAR_(char_type, '&'):
+                ++cur;
+                this->op_(format_op::sub_match, 0, 0);
+                break;
+
+            case BOOST_XPR_CHAR_(char_type, '\\'):
+                this->compile_escape_(++cur, end);
+                break;
+
+            default:
+                this->literal_(*cur++);
+                break;
+            }
+        }
+    }
+
+    /// INTERNAL ONLY
+    void compile_perl_(iterator cur, iterator end)
+    {
+        while(cur != end)
+        {
+            switch(*cur)
+            {
+            case BOOST_XPR_CHAR_(char_type, '$'):
+                this->compile_backref_(++cur, end);
+                break;
+
+            case BOOST_XPR_CHAR_(char_type, '\\'):
+                if(++cur != end && BOOST_XPR_CHAR_(char_type, 'g') == *cur)
+                {
+                    this->compile_named_backref_(++cur, end);
+                }
+                else
+                {
+                    this->compile_escape_(cur, end);
+                }
+                break;
+
+            default:
+                this->literal_(*cur++);
+                break;
+            }
+        }
+    }
+
+    /// INTERNAL ONLY
+    // follows match_results<>::format_all_impl_, which picks a branch of a
+    // conditional as it goes; here, both branches are compiled
+    void compile_all_(iterator &cur, iterator end, bool metacolon = false)
+    {
+        while(cur != end)
+        {
+            switch(*cur)
+            {
+            case BOOST_XPR_CHAR_(char_type, '$'):
+                this->compile_backref_(++cur, end);
+                break;
+
+            case BOOST_XPR_CHAR_(char_type, '\\'):
+                if(++cur != end && BOOST_XPR_CHAR_(char_type, 'g') == *cur)
+                {
+                    this->compile_named_backref_(++cur, end);
+                }
+                else
+                {
+                    this->compile_escape_(cur, end);
+                }
+                break;
+
+            case BOOST_XPR_CHAR_(char_type, '('):
+                this->compile_all_(++cur, end);
+                BOOST_XPR_ENSURE_(BOOST_XPR_CHAR_(char_type, ')') == *(cur-1)
+                  , regex_constants::error_paren, "unbalanced parentheses in format string");
+                break;
+
+            case BOOST_XPR_CHAR_(char_type, '?'):
+                {
+                    BOOST_XPR_ENSURE_(++cur != end
+                      , regex_constants::error_subreg, "malformed conditional in format string");
+                    int sub = detail::toi(cur, end, *this->traits_, 10, this->max_);
+                    BOOST_XPR_ENSURE_(0 != sub, regex_constants::error_subreg, "invalid back-reference");
+                    std::size_t branch = this->op_(format_op::if_unmatched, static_cast<std::size_t>(sub));
+                    this->compile_all_(cur, end, true);
+                    if(BOOST_XPR_CHAR_(char_type, ':') == *(cur-1))
+                    {
+                        std::size_t jump = this->op_(format_op::jump);
+                        this->ops_[branch].second_ = this->label_();
+                        this->compile_all_(cur, end);
+                        this->ops_[jump].second_ = this->label_();
+                    }
+                    else
+                    {
+                        this->ops_[branch].second_ = this->label_();
+                    }
+                }
+                return;
+
+            case BOOST_XPR_CHAR_(char_type, ':'):
+                if(metacolon)
+                {
+                    BOOST_FALLTHROUGH;
+            case BOOST_XPR_CHAR_(char_type, ')'):
+                    ++cur;
+                    return;
+                }
+                BOOST_FALLTHROUGH;
+
+            default:
+                this->literal_(*cur++);
+                break;
+            }
+        }
+    }
+
+    /// INTERNAL ONLY
+    void compile_backref_(iterator &cur, iterator end)
+    {
+        if(cur == end)
+        {
+            this->literal_(BOOST_XPR_CHAR_(char_type, '$'));
+        }
+        else if(BOOST_XPR_CHAR_(char_type, '$') == *cur)
+        {
+            this->literal_(*cur++);
+        }
+        else if(BOOST_XPR_CHAR_(char_type, '&') == *cur) // whole match
+        {
+            ++cur;
+            this->op_(format_op::sub_match, 0, 0);
+        }
+        else if(BOOST_XPR_CHAR_(char_type, '`') == *cur) // prefix
+        {
+            ++cur;
+            this->op_(format_op::prefix);
+        }
+        else if(BOOST_XPR_CHAR_(char_type, '\'') == *cur) // suffix
+        {
+            ++cur;
+            this->op_(format_op::suffix);
+        }
+        else if(-1 != this->traits_->value(*cur, 10)) // a sub-match
+        {
+            int sub = detail::toi(cur, end, *this->traits_, 10, this->max_);
+            BOOST_XPR_ENSURE_(0 != sub, regex_constants::error_subreg, "invalid back-reference");
+            this->op_(format_op::sub_match, static_cast<std::size_t>(sub), 1);
+        }
+        else
+        {
+            this->literal_(BOOST_XPR_CHAR_(char_type, '$'));
+            this->literal_(*cur++);
+        }
+    }
+
+    /// INTERNAL ONLY
+    void compile_escape_(iterator &cur, iterator end)
+    {
+        using namespace regex_constants;
+        iterator tmp;
+        // define an unsigned type the same size as char_type
+        typedef typename boost::uint_t<CHAR_BIT * sizeof(char_type)>::least uchar_t;
+        BOOST_MPL_ASSERT_RELATION(sizeof(uchar_t), ==, sizeof(char_type));
+        typedef numeric::conversion_traits<uchar_t, int> converstion_traits;
+        numeric::converter<int, uchar_t, converstion_traits, detail::char_overflow_handler_> converter;
+
+        if(cur == end)
+        {
+            this->literal_(BOOST_XPR_CHAR_(char_type, '\\'));
+            return;
+        }
+
+        char_type ch = *cur++;
+        switch(ch)
+        {
+        case BOOST_XPR_CHAR_(char_type, 'a'):
+            this->literal_(BOOST_XPR_CHAR_(char_type, '\a'));
+            break;
+
+        case BOOST_XPR_CHAR_(char_type, 'e'):
+            this->literal_(converter(27));
+            break;
+
+        case BOOST_XPR_CHAR_(char_type, 'f'):
+            this->literal_(BOOST_XPR_CHAR_(char_type, '\f'));
+            break;
+
+        case BOOST_XPR_CHAR_(char_type, 'n'):
+            this->literal_(BOOST_XPR_CHAR_(char_type, '\n'));
+            break;
+
+        case BOOST_XPR_CHAR_(char_type, 'r'):
+            this->literal_(BOOST_XPR_CHAR_(char_type, '\r'));
+            break;
+
+        case BOOST_XPR_CHAR_(char_type, 't'):
+            this->literal_(BOOST_XPR_CHAR_(char_type, '\t'));
+            break;
+
+        case BOOST_XPR_CHAR_(char_type, 'v'):
+            this->literal_(BOOST_XPR_CHAR_(char_type, '\v'));
+            break;
+
+        case BOOST_XPR_CHAR_(char_type, 'x'):
+            BOOST_XPR_ENSURE_(cur != end, error_escape, "unexpected end of format found");
+            if(BOOST_XPR_CHAR_(char_type, '{') == *cur)
+            {
+                BOOST_XPR_ENSURE_(++cur != end, error_escape, "unexpected end of format found");
+                tmp = cur;
+                this->literal_(converter(detail::toi(cur, end, *this->traits_, 16, 0xffff)));
+                BOOST_XPR_ENSURE_(4 == std::distance(tmp, cur) && cur != end && BOOST_XPR_CHAR_(char_type, '}') == *cur++
+                  , error_escape, "invalid hex escape : must be \\x { HexDigit HexDigit HexDigit HexDigit }");
+            }
+            else
+            {
+                tmp = cur;
+                this->literal_(converter(detail::toi(cur, end, *this->traits_, 16, 0xff)));
+                BOOST_XPR_ENSURE_(2 == std::distance(tmp, cur), error_escape
+                  , "invalid hex escape : must be \\x HexDigit HexDigit");
+            }
+            break;
+
+        case BOOST_XPR_CHAR_(char_type, 'c'):
+            BOOST_XPR_ENSURE_(cur != end, error_escape, "unexpected end of format found");
+            BOOST_XPR_ENSURE_
+            (
+                this->traits_->in_range(BOOST_XPR_CHAR_(char_type, 'a'), BOOST_XPR_CHAR_(char_type, 'z'), *cur)
+             || this->traits_->in_range(BOOST_XPR_CHAR_(char_type, 'A'), BOOST_XPR_CHAR_(char_type, 'Z'), *cur)
+              , error_escape
+              , "invalid escape control letter; must be one of a-z or A-Z"
+            );
+            // Convert to character according to ECMA-262, section 15.10.2.10:
+            this->literal_(converter(*cur % 32));
+            ++cur;
+            break;
+
+        case BOOST_XPR_CHAR_(char_type, 'l'):
+            this->transform_(ch, detail::op_lower, detail::scope_next);
+            break;
+
+        case BOOST_XPR_CHAR_(char_type, 'L'):
+            this->transform_(ch, detail::op_lower, detail::scope_rest);
+            break;
+
+        case BOOST_XPR_CHAR_(char_type, 'u'):
+            this->transform_(ch, detail::op_upper, detail::scope_next);
+            break;
+
+        case BOOST_XPR_CHAR_(char_type, 'U'):
+            this->transform_(ch, detail::op_upper, detail::scope_rest);
+            break;
+
+        case BOOST_XPR_CHAR_(char_type, 'E'):
+            this->transform_(ch, detail::op_none, detail::scope_rest);
+            break;
+
+        default:
+            if(0 < this->traits_->value(ch, 10))
+            {
+                this->op_(format_op::sub_match, static_cast<std::size_t>(this->traits_->value(ch, 10)), 1);
+            }
+            else
+            {
+                this->literal_(ch);
+            }
+            break;
+        }
+    }
+
+    /// INTERNAL ONLY
+    // case conversions only apply to perl and format_all format strings
+    void transform_(char_type ch, detail::transform_op trans, detail::transform_scope scope)
+    {
+        if(this->case_converting_)
+        {
+            this->op_(format_op::transform, trans, scope);
+        }
+        else
+        {
+            this->literal_(ch);
+        }
+    }
+
+    /// INTERNAL ONLY
+    void compile_named_backref_(iterator &cur, iterator end)
+    {
+        using namespace regex_constants;
+        BOOST_XPR_ENSURE_(cur != end && BOOST_XPR_CHAR_(char_type, '<') == *cur++
+            , error_badmark, "invalid named back-reference");
+        iterator begin = cur;
+        for(; cur != end && BOOST_XPR_CHAR_(char_type, '>') != *cur; ++cur)
+        {}
+        BOOST_XPR_ENSURE_(cur != begin && cur != end && BOOST_XPR_CHAR_(char_type, '>') == *cur
+            , error_badmark, "invalid named back-reference");
+
+        detail::named_mark<char_type> const *mark =
+            this->named_marks_ ? this->named_marks_->find(begin, cur) : 0;
+        ++cur;
+        BOOST_XPR_ENSURE_(0 != mark, error_badmark, "invalid named back-reference");
+        this->op_(format_op::sub_match, mark->mark_nbr_, 0);
+    }
+
+    /// INTERNAL ONLY
+    template<typename OutputIterator>
+    OutputIterator format_ops_(match_results<BidiIter> const &what, OutputIterator out) const
+    {
+        char_type const *literals = this->literals_.empty() ? 0 : &this->literals_[0];
+        for(std::size_t i = 0, size = this->ops_.size(); i != size;)
+        {
+            format_op const &op = this->ops_[i++];
+            switch(op.kind_)
+            {
+            case format_op::literal:
+                out = std::copy(literals + op.first_, literals + op.first_ + op.second_, out);
+                break;
+
+            case format_op::sub_match:
+                if(0 == op.second_ || what[op.first_].matched)
+                {
+                    out = std::copy(what[op.first_].first, what[op.first_].second, out);
+                }
+                break;
+
+            case format_op::prefix:
+                out = std::copy(what.prefix().first, what.prefix().second, out);
+                break;
+
+            case format_op::suffix:
+                out = std::copy(what.suffix().first, what.suffix().second, out);
+                break;
+
+            case format_op::transform:
+                set_transform(out, detail::transform_op(op.first_), detail::transform_scope(op.second_));
+                break;
+
+            case format_op::if_unmatched:
+                if(!what[op.first_].matched)
+                {
+                    i = op.second_;
+                }
+                break;
+
+            case format_op::jump:
+                i = op.second_;
+                break;
+            }
+        }
+        return out;
+    }
+
+    string_type format_;
+    flag_type flags_;
+    intrusive_ptr<detail::matchable_ex<BidiIter> const> xpr_;
+    intrusive_ptr<detail::traits<char_type> const> traits_;
+    bool case_converting_;
+    std::vector<char_type> literals_;
+    std::vector<format_op> ops_;
+
+    // only used while compiling
+    detail::named_marks<char_type> const *named_marks_;
+    int max_;
+    bool merge_;
+};
+
+}} // namespace boost::xpressive
+
+#endif
@@ -71,7 +71,7 @@ public:
 
     BOOST_STATIC_CONSTANT(regex_constants::syntax_option_type, ECMAScript         = regex_constants::ECMAScript);
     BOOST_STATIC_CONSTANT(regex_constants::syntax_option_type, icase              = regex_constants::icase_);
-    BOOST_STATIC_CONSTANT(regex_constants::syntax_option_type, nosubs             = regex_constants::nosubs);
+    BOOST_STATIC_CONSTANT(regex_constants::syntax_option_type, nosubs             = regex_constants::nosubs_);
     BOOST_STATIC_CONSTANT(regex_constants::syntax_option_type, optimize           = regex_constants::optimize);
     BOOST_STATIC_CONSTANT(regex_constants::syntax_option_type, collate            = regex_constants::collate);
     BOOST_STATIC_CONSTANT(regex_constants::syntax_option_type, single_line        = regex_constants::single_line);
@@ -104,6 +104,31 @@ public:
         return *this;
     }
 
+    #ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+    /// \param that The basic_regex object to move from. Any regex that embeds
+    ///        that by reference now refers to *this.
+    /// \post regex_id()      == the old value of that.regex_id()
+    /// \post that.regex_id() == 0
+    /// \throw nothrow
+    basic_regex(basic_regex<BidiIter> &&that) BOOST_NOEXCEPT
+      : base_type()
+    {
+        proto::value(*this).swap(proto::value(that));
+    }
+
+    /// \param that The basic_regex object to move from.
+    /// \post regex_id()      == the old value of that.regex_id()
+    /// \post that.regex_id() == 0
+    /// \return *this
+    /// \throw nothrow, unless *this is embedded by reference in another regex,
+    ///        in which case that is copied so the change is visible to it.
+    basic_regex<BidiIter> &operator =(basic_regex<BidiIter> &&that)
+    {
+        proto::value(*this) = static_cast<detail::tracking_ptr<detail::regex_impl<BidiIter> > &&>(proto::value(that));
+        return *this;
+    }
+    #endif
+
     /// Construct from a static regular expression.
     ///
     /// \param  expr The static regular expression
@@ -141,6 +166,26 @@ public:
         return proto::value(*this) ? proto::value(*this)->mark_count_ : 0;
     }
 
+    /// Returns the number of the sub-expression with the specified name, so that
+    /// it can be looked up by number in a match_results object.
+    ///
+    /// \param     name The name of a named capture, as in <tt>(?P\<name\>...)</tt>.
+    /// \throw     regex_error when there is no sub-expression with that name.
+    std::size_t mark_number(char_type const *name) const
+    {
+        char_type const *end = name;
+        for(; char_type() != *end; ++end)
+        {}
+        return this->mark_number_(name, end);
+    }
+
+    /// \overload
+    ///
+    std::size_t mark_number(string_type const &name) const
+    {
+        return this->mark_number_(name.begin(), name.end());
+    }
+
     /// Returns a token which uniquely identifies this regular expression.
     ///
     regex_id_type regex_id() const
@@ -223,6 +268,19 @@ private:
     /// INTERNAL ONLY
     basic_regex(string_type const &);
 
+    /// INTERNAL ONLY
+    template<typename FwdIter>
+    std::size_t mark_number_(FwdIter begin, FwdIter end) const
+    {
+        detail::named_mark<char_type> const *mark = 0;
+        if(proto::value(*this) && proto::value(*this)->named_marks_)
+        {
+            mark = proto::value(*this)->named_marks_->find(begin, end);
+        }
+        BOOST_XPR_ENSURE_(0 != mark, regex_constants::error_badmark, "invalid named back-reference");
+        return mark->mark_nbr_;
+    }
+
     /// INTERNAL ONLY
     bool match_(detail::match_state<BidiIter> &state) const
     {
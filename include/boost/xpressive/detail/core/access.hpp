@@ -18,7 +18,7 @@
 #include <boost/proto/traits.hpp>
 #include <boost/xpressive/detail/detail_fwd.hpp>
 #include <boost/xpressive/detail/dynamic/matchable.hpp>
-#include <boost/xpressive/match_results.hpp> // for type_info_less
+#include <boost/xpressive/match_results.hpp> // for action_args
 
 namespace boost { namespace xpressive { namespace detail
 {
@@ -47,6 +47,13 @@ struct core_access
         return proto::value(rex).get();
     }
 
+    // Unlike get_regex_impl(), this doesn't un-share the implementation, so
+    // it neither allocates nor touches any reference counts.
+    static regex_impl<BidiIter> const &get_regex_impl_ref(basic_regex<BidiIter> const &rex)
+    {
+        return *proto::value(rex);
+    }
+
     static void init_sub_match_vector
     (
         sub_match_vector<BidiIter> &subs_vect
@@ -75,7 +82,7 @@ struct core_access
       , intrusive_ptr<traits<char_type> const> const &tr
       , sub_match_impl<BidiIter> *sub_matches
       , std::size_t size
-      , std::vector<named_mark<char_type> > const &named_marks
+      , intrusive_ptr<named_marks<char_type> > const &named_marks
     )
     {
         what.init_(regex_id, tr, sub_matches, size, named_marks);
@@ -14,7 +14,7 @@
 #endif
 
 #include <boost/xpressive/detail/detail_fwd.hpp>
-#include <boost/xpressive/match_results.hpp> // for type_info_less
+#include <boost/xpressive/match_results.hpp> // for action_args
 
 namespace boost { namespace xpressive { namespace detail
 {
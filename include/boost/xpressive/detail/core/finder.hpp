@@ -14,6 +14,7 @@
 # pragma warning(disable : 4189) // local variable is initialized but not referenced
 #endif
 
+#include <cstring>
 #include <boost/xpressive/detail/detail_fwd.hpp>
 #include <boost/xpressive/detail/core/regex_impl.hpp>
 #include <boost/xpressive/detail/utility/boyer_moore.hpp>
@@ -55,6 +56,47 @@ private:
     boyer_moore<BidiIter, Traits> bm_;
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// memchr_finder
+//   finds a leading character with memchr. BidiIter must be contiguous, its
+//   value_type must be char, and the traits must not translate characters.
+template<typename BidiIter>
+struct memchr_finder
+  : finder<BidiIter>
+{
+    typedef typename iterator_difference<BidiIter>::type diff_type;
+
+    explicit memchr_finder(char ch)
+      : ch_(ch)
+    {
+    }
+
+    bool operator ()(match_state<BidiIter> &state) const
+    {
+        if(state.cur_ == state.end_)
+        {
+            return false;
+        }
+
+        char const *begin = &*state.cur_;
+        void const *found = std::memchr(begin, this->ch_, static_cast<std::size_t>(state.end_ - state.cur_));
+        if(0 == found)
+        {
+            state.cur_ = state.end_;
+            return false;
+        }
+
+        state.cur_ += static_cast<diff_type>(static_cast<char const *>(found) - begin);
+        return true;
+    }
+
+private:
+    memchr_finder(memchr_finder const &);
+    memchr_finder &operator =(memchr_finder const &);
+
+    char ch_;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // hash_peek_finder
 //
@@ -16,32 +16,149 @@
 #include <boost/xpressive/detail/detail_fwd.hpp>
 #include <boost/xpressive/detail/core/regex_impl.hpp>
 #include <boost/xpressive/detail/core/state.hpp>
+#include <boost/xpressive/detail/core/memo_table.hpp>
 #include <boost/xpressive/detail/utility/ignore_unused.hpp>
 
 namespace boost { namespace xpressive { namespace detail
 {
 
+///////////////////////////////////////////////////////////////////////////////
+// memo_context_match
+//   Like push_context_match, but with match_memoize. The first time the nested
+//   regex is tried at a position, every position at which it ends is recorded.
+//   If it turns out to have no more ends, the record is complete and is kept.
+//   After that, a nested regex with no ends there fails right away, and one
+//   invoked without nested results just tries what follows at each recorded end,
+//   provided that moving the position was all it did.
+template<typename BidiIter>
+inline bool memo_context_match
+(
+    regex_impl<BidiIter> const &impl
+  , match_state<BidiIter> &state
+  , matchable<BidiIter> const &next
+  , bool nosubs
+)
+{
+    memo_table &memo = state.extras_->memo_;
+    std::ptrdiff_t const pos = state.position();
+    bool recording = true;
+
+    if(memo_table::entry const *found = memo.find(impl.xpr_.get(), pos))
+    {
+        memo_table::entry const entry = *found;
+        if(0 == entry.size_)
+        {
+            return false;
+        }
+        else if(nosubs)
+        {
+            for(std::size_t i = 0; i != entry.size_; ++i)
+            {
+                // (the ends may move while next is matched, so look them up each time)
+                state.position(memo.ends(entry)[i]);
+                if(next.match(state))
+                {
+                    return true;
+                }
+            }
+            state.position(pos);
+            return false;
+        }
+        recording = false;
+    }
+
+    memo_record record =
+    {
+        memo_table::chain()
+      , state.context_.results_ptr_->nested_results().size()
+      , state.action_list_tail_
+      , nosubs
+      , true
+    };
+
+    // save state
+    match_context<BidiIter> context = nosubs
+      ? state.push_nosubs_context(impl, next, context)
+      : state.push_context(impl, next, context);
+    detail::ignore_unused(context);
+    state.context_.memo_record_ = recording ? &record : 0;
+
+    bool const success = impl.xpr_->match(state);
+
+    if(recording)
+    {
+        // a nested regex with no ends can't match here, whatever follows it.
+        // If it ended without moving, what follows may have tried it here again
+        // and committed its ends first.
+        if(!success && record.complete_ && (record.replayable_ || 0 == record.ends_.size_)
+            && 0 == memo.find(impl.xpr_.get(), pos))
+        {
+            memo.record_commit(impl.xpr_.get(), pos, record.ends_, state.extras_->max_retained_bytes_);
+        }
+    }
+
+    // uninitialize the match context (reclaims the sub_match objects if necessary)
+    return state.pop_context(impl, success);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// memo_record_end
+//   Called with match_memoize when a nested regex reaches its end. Returns false
+//   if it has already ended here, in which case what follows has already failed.
+template<typename BidiIter>
+inline bool memo_record_end(match_state<BidiIter> &state, memo_record &record)
+{
+    memo_table &memo = state.extras_->memo_;
+    std::ptrdiff_t const end = state.position();
+    if(memo.recorded(record.ends_, end))
+    {
+        return false;
+    }
+
+    if(record.replayable_ && (
+        record.nested_results_count_ != state.context_.results_ptr_->nested_results().size() ||
+        record.action_list_tail_ != state.action_list_tail_))
+    {
+        record.replayable_ = false;
+    }
+
+    if(record.complete_ && !memo.record(record.ends_, end, state.extras_->max_retained_bytes_))
+    {
+        record.complete_ = false;
+    }
+
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // push_context_match
-//
+//   If nosubs is true, the nested regex doesn't get a nested match_results of its own.
 template<typename BidiIter>
 inline bool push_context_match
 (
     regex_impl<BidiIter> const &impl
   , match_state<BidiIter> &state
   , matchable<BidiIter> const &next
+  , bool nosubs = false
 )
 {
     // avoid infinite recursion
     // BUGBUG this only catches direct infinite recursion, like sregex::compile("(?R)"), but
     // not indirect infinite recursion where two rules invoke each other recursively.
-    if(state.is_active_regex(impl) && state.cur_ == state.sub_match(0).begin_)
+    if(state.is_active_regex(impl) && state.cur_ == state.sub_match(0).begin_.get(state.begin_))
     {
         return next.match(state);
     }
 
+    if(state.memoize())
+    {
+        return memo_context_match(impl, state, next, nosubs);
+    }
+
     // save state
-    match_context<BidiIter> context = state.push_context(impl, next, context);
+    match_context<BidiIter> context = nosubs
+      ? state.push_nosubs_context(impl, next, context)
+      : state.push_context(impl, next, context);
     detail::ignore_unused(context);
 
     // match the nested regex and uninitialize the match context
@@ -55,6 +172,11 @@ inline bool push_context_match
 template<typename BidiIter>
 inline bool pop_context_match(match_state<BidiIter> &state)
 {
+    if(0 != state.context_.memo_record_ && !memo_record_end(state, *state.context_.memo_record_))
+    {
+        return false;
+    }
+
     // save state
     // BUGBUG nested regex could have changed state.traits_
     match_context<BidiIter> &context(*state.context_.prev_context_);
@@ -19,6 +19,8 @@
 #endif
 #include <stack>
 #include <limits>
+#include <climits>
+#include <algorithm>
 #include <typeinfo>
 #include <boost/shared_ptr.hpp>
 #include <boost/type_traits/is_same.hpp>
@@ -62,7 +64,33 @@ struct icase_modifier
     static typename apply<Visitor>::type
     call(Visitor &visitor)
     {
-        return typename apply<Visitor>::type(visitor.traits(), visitor.self());
+        typename apply<Visitor>::type that(visitor.traits(), visitor.self());
+        that.nosubs(visitor.nosubs());
+        return that;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// nosubs_modifier
+//
+//   wrapped by the modifier<> template and inserted into the xpression
+//   template with the nosubs() helper function. nosubs_modifier flags the
+//   visitor so that the nested regexes it visits don't create nested results.
+//
+struct nosubs_modifier
+{
+    template<typename Visitor>
+    struct apply
+    {
+        typedef Visitor type;
+    };
+
+    template<typename Visitor>
+    static Visitor call(Visitor &visitor)
+    {
+        Visitor that(visitor);
+        that.nosubs(true);
+        return that;
     }
 };
 
@@ -122,7 +150,9 @@ struct locale_modifier
     typename apply<Visitor>::type
     call(Visitor &visitor) const
     {
-        return typename apply<Visitor>::type(this->loc_, visitor.self());
+        typename apply<Visitor>::type that(this->loc_, visitor.self());
+        that.nosubs(visitor.nosubs());
+        return that;
     }
 
     Locale getloc() const
@@ -143,6 +173,7 @@ struct xpression_linker
     template<typename Traits>
     explicit xpression_linker(Traits const &tr)
       : back_stack_()
+      , mark_stack_()
       , traits_(&tr)
       , traits_type_(&typeid(Traits))
       , has_backrefs_(false)
@@ -173,14 +204,26 @@ struct xpression_linker
         this->has_backrefs_ = true;
     }
 
-    void accept(repeat_begin_matcher const &, void const *next)
+    void accept(mark_begin_matcher const &matcher, void const *)
+    {
+        this->add_mark_(matcher.mark_number_);
+    }
+
+    void accept(mark_end_matcher const &matcher, void const *)
+    {
+        this->add_mark_(matcher.mark_number_);
+    }
+
+    void accept(repeat_begin_matcher const &matcher, void const *next)
     {
+        this->add_mark_(matcher.mark_number_);
         this->back_stack_.push(next);
     }
 
     template<typename Greedy>
     void accept(repeat_end_matcher<Greedy> const &matcher, void const *)
     {
+        this->add_mark_(matcher.mark_number_);
         matcher.back_ = this->back_stack_.top();
         this->back_stack_.pop();
     }
@@ -208,6 +251,7 @@ struct xpression_linker
     template<typename Xpr, typename Greedy>
     void accept(optional_mark_matcher<Xpr, Greedy> const &matcher, void const *next)
     {
+        this->add_mark_(matcher.mark_number_);
         this->back_stack_.push(next);
         matcher.xpr_.link(*this);
     }
@@ -215,19 +259,19 @@ struct xpression_linker
     template<typename Xpr>
     void accept(keeper_matcher<Xpr> const &matcher, void const *)
     {
-        matcher.xpr_.link(*this);
+        this->independent_link_(matcher.xpr_, matcher.marks_);
     }
 
     template<typename Xpr>
     void accept(lookahead_matcher<Xpr> const &matcher, void const *)
     {
-        matcher.xpr_.link(*this);
+        this->independent_link_(matcher.xpr_, matcher.marks_);
     }
 
     template<typename Xpr>
     void accept(lookbehind_matcher<Xpr> const &matcher, void const *)
     {
-        matcher.xpr_.link(*this);
+        this->independent_link_(matcher.xpr_, matcher.marks_);
     }
 
     template<typename Xpr, typename Greedy>
@@ -307,6 +351,39 @@ private:
 #endif
     }
 
+    // Links the sub-expression of a keeper or a look-around assertion, and
+    // records which sub-matches it can write, so that only those need to be
+    // saved when it is matched.
+    template<typename Xpr>
+    void independent_link_(Xpr const &xpr, mark_range &marks)
+    {
+        this->mark_stack_.push(mark_range(INT_MAX, 0));
+        xpr.link(*this);
+        marks = this->mark_stack_.top();
+        this->mark_stack_.pop();
+
+        if(marks.end_ <= marks.begin_)
+        {
+            marks = mark_range(0, 0);
+        }
+        else if(!this->mark_stack_.empty())
+        {
+            this->add_mark_(marks.begin_);
+            this->add_mark_(marks.end_ - 1);
+        }
+    }
+
+    // Hidden marks have negative numbers. They are never saved.
+    void add_mark_(int mark_number)
+    {
+        if(0 <= mark_number && !this->mark_stack_.empty())
+        {
+            mark_range &top = this->mark_stack_.top();
+            top.begin_ = (std::min)(top.begin_, mark_number);
+            top.end_ = (std::max)(top.end_, mark_number + 1);
+        }
+    }
+
     template<typename Traits>
     Traits const &get_traits() const
     {
@@ -315,6 +392,7 @@ private:
     }
 
     std::stack<void const *> back_stack_;
+    std::stack<mark_range> mark_stack_;
     void const *traits_;
     std::type_info const *traits_type_;
     bool has_backrefs_;
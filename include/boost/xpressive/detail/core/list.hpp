@@ -2,7 +2,7 @@
 // list.hpp
 //    A simple implementation of std::list that allows incomplete
 //    types, does no dynamic allocation in the default constructor,
-//    and has a guarnteed O(1) splice.
+//    and has a guarnteed O(1) splice and size.
 //
 //  Copyright 2009 Eric Niebler. Distributed under the Boost
 //  Software License, Version 1.0. (See accompanying file
@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <boost/assert.hpp>
 #include <boost/iterator/iterator_facade.hpp>
+#include <boost/xpressive/detail/utility/byte_allocator.hpp>
 
 namespace boost { namespace xpressive { namespace detail
 {
@@ -40,7 +41,8 @@ namespace boost { namespace xpressive { namespace detail
 
         struct node : node_base
         {
-            explicit node(T const &value)
+            template<typename U>
+            explicit node(U const &value)
               : _value(value)
             {}
 
@@ -48,6 +50,8 @@ namespace boost { namespace xpressive { namespace detail
         };
 
         node_base _sentry;
+        std::size_t _size;
+        byte_allocator *_alloc;
 
         template<typename Ref = T &>
         struct list_iterator
@@ -74,12 +78,17 @@ namespace boost { namespace xpressive { namespace detail
         typedef list_iterator<T const &> const_iterator;
         typedef std::size_t size_type;
 
-        list()
+        explicit list(byte_allocator *alloc = 0)
+          : _size(0)
+          , _alloc(alloc)
         {
             _sentry._next = _sentry._prev = &_sentry;
         }
 
+        // copies don't inherit the allocator; they may outlive it
         list(list const &that)
+          : _size(0)
+          , _alloc(0)
         {
             _sentry._next = _sentry._prev = &_sentry;
             const_iterator it = that.begin(), e = that.end();
@@ -89,7 +98,11 @@ namespace boost { namespace xpressive { namespace detail
 
         list &operator =(list const &that)
         {
-            list(that).swap(*this);
+            list tmp(_alloc);
+            const_iterator it = that.begin(), e = that.end();
+            for( ; it != e; ++it)
+                tmp.push_back(*it);
+            tmp.swap(*this);
             return *this;
         }
 
@@ -110,28 +123,39 @@ namespace boost { namespace xpressive { namespace detail
             temp.splice(temp.begin(), that);  // move that to temp
             that.splice(that.begin(), *this); // move this to that
             splice(begin(), temp);            // move temp to this
+            std::swap(_alloc, that._alloc);
+        }
+
+        byte_allocator *get_allocator() const
+        {
+            return _alloc;
         }
 
-        void push_front(T const &t)
+        template<typename U>
+        void push_front(U const &t)
         {
-            node *new_node = new node(t);
+            node *new_node = new_with<node>(_alloc, t);
 
             new_node->_next = _sentry._next;
             new_node->_prev = &_sentry;
 
             _sentry._next->_prev = new_node;
             _sentry._next = new_node;
+            ++_size;
         }
 
-        void push_back(T const &t)
+        // constructs the new element from t, which needn't be a T
+        template<typename U>
+        void push_back(U const &t)
         {
-            node *new_node = new node(t);
+            node *new_node = new_with<node>(_alloc, t);
 
             new_node->_next = &_sentry;
             new_node->_prev = _sentry._prev;
 
             _sentry._prev->_next = new_node;
             _sentry._prev = new_node;
+            ++_size;
         }
 
         void pop_front()
@@ -140,7 +164,8 @@ namespace boost { namespace xpressive { namespace detail
             node *old_node = static_cast<node *>(_sentry._next);
             _sentry._next = old_node->_next;
             _sentry._next->_prev = &_sentry;
-            delete old_node;
+            --_size;
+            delete_with(_alloc, old_node);
         }
 
         void pop_back()
@@ -149,7 +174,8 @@ namespace boost { namespace xpressive { namespace detail
             node *old_node = static_cast<node *>(_sentry._prev);
             _sentry._prev = old_node->_prev;
             _sentry._prev->_next = &_sentry;
-            delete old_node;
+            --_size;
+            delete_with(_alloc, old_node);
         }
 
         bool empty() const
@@ -169,9 +195,11 @@ namespace boost { namespace xpressive { namespace detail
             it._node->_prev = x._sentry._prev;
 
             x._sentry._prev = x._sentry._next = &x._sentry;
+            _size += x._size;
+            x._size = 0;
         }
 
-        void splice(iterator it, list &, iterator xit)
+        void splice(iterator it, list &x, iterator xit)
         {
             xit._node->_prev->_next = xit._node->_next;
             xit._node->_next->_prev = xit._node->_prev;
@@ -180,6 +208,8 @@ namespace boost { namespace xpressive { namespace detail
             xit._node->_prev = it._node->_prev;
 
             it._node->_prev = it._node->_prev->_next = xit._node;
+            ++_size;
+            --x._size;
         }
 
         reference front()
@@ -226,9 +256,15 @@ namespace boost { namespace xpressive { namespace detail
             return const_iterator(const_cast<node_base *>(&_sentry));
         }
 
+        // the memory used by each element
+        static size_type node_size()
+        {
+            return sizeof(node);
+        }
+
         size_type size() const
         {
-            return static_cast<size_type>(std::distance(begin(), end()));
+            return _size;
         }
     };
 
@@ -31,7 +31,7 @@
 #include <boost/xpressive/detail/core/state.hpp>
 #include <boost/proto/core.hpp>
 #include <boost/proto/context.hpp>
-#include <boost/xpressive/match_results.hpp> // for type_info_less
+#include <boost/xpressive/match_results.hpp> // for action_args
 #include <boost/xpressive/detail/static/transforms/as_action.hpp> // for 'read_attr'
 #if BOOST_VERSION >= 103500
 # include <boost/proto/fusion.hpp>
@@ -47,20 +47,20 @@ namespace boost { namespace xpressive { namespace detail
                 }
 
                 // record the end of sub-match zero
-                s0.first = s0.begin_;
+                s0.first = s0.begin_.get(state.begin_);
                 s0.second = tmp;
                 s0.matched = true;
 
                 return true;
             }
             else if((state.flags_.match_all_ && !state.eos()) ||
-                    (state.flags_.match_not_null_ && state.cur_ == s0.begin_))
+                    (state.flags_.match_not_null_ && state.cur_ == s0.begin_.get(state.begin_)))
             {
                 return false;
             }
 
             // record the end of sub-match zero
-            s0.first = s0.begin_;
+            s0.first = s0.begin_.get(state.begin_);
             s0.second = tmp;
             s0.matched = true;
 
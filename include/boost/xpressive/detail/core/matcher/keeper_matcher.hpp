@@ -31,6 +31,7 @@ namespace boost { namespace xpressive { namespace detail
         keeper_matcher(Xpr const &xpr, bool pure = Xpr::pure)
           : xpr_(xpr)
           , pure_(pure)
+          , marks_()
         {
         }
 
@@ -67,7 +68,7 @@ namespace boost { namespace xpressive { namespace detail
             BidiIter const tmp = state.cur_;
 
             // matching xpr could produce side-effects, save state
-            memento<BidiIter> mem = save_sub_matches(state);
+            memento<BidiIter> mem = save_sub_matches(state, this->marks_);
 
             if(!this->xpr_.match(state))
             {
@@ -89,6 +90,7 @@ namespace boost { namespace xpressive { namespace detail
 
         Xpr xpr_;
         bool pure_; // false if matching xpr_ could modify the sub-matches
+        mutable mark_range marks_; // the sub-matches xpr_ can modify, set by the linker
     };
 
 }}}
@@ -36,6 +36,7 @@ namespace boost { namespace xpressive { namespace detail
           : xpr_(xpr)
           , not_(no)
           , pure_(pure)
+          , marks_()
         {
         }
 
@@ -96,7 +97,7 @@ namespace boost { namespace xpressive { namespace detail
             BidiIter const tmp = state.cur_;
 
             // matching xpr could produce side-effects, save state
-            memento<BidiIter> mem = save_sub_matches(state);
+            memento<BidiIter> mem = save_sub_matches(state, this->marks_);
 
             if(this->not_)
             {
@@ -144,6 +145,7 @@ namespace boost { namespace xpressive { namespace detail
         Xpr xpr_;
         bool not_;
         bool pure_; // false if matching xpr_ could modify the sub-matches
+        mutable mark_range marks_; // the sub-matches xpr_ can modify, set by the linker
     };
 
 }}}
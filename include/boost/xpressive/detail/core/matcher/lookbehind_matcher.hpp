@@ -37,6 +37,7 @@ namespace boost { namespace xpressive { namespace detail
           : xpr_(xpr)
           , not_(no)
           , pure_(pure)
+          , marks_()
           , width_(wid)
         {
             BOOST_XPR_ENSURE_(!is_unknown(this->width_), regex_constants::error_badlookbehind,
@@ -110,7 +111,7 @@ namespace boost { namespace xpressive { namespace detail
             }
 
             // matching xpr could produce side-effects, save state
-            memento<BidiIter> mem = save_sub_matches(state);
+            memento<BidiIter> mem = save_sub_matches(state, this->marks_);
 
             if(this->not_)
             {
@@ -160,6 +161,7 @@ namespace boost { namespace xpressive { namespace detail
         Xpr xpr_;
         bool not_;
         bool pure_; // false if matching xpr_ could modify the sub-matches
+        mutable mark_range marks_; // the sub-matches xpr_ can modify, set by the linker
         std::size_t width_;
     };
 
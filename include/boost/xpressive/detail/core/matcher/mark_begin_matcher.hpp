@@ -38,8 +38,8 @@ namespace boost { namespace xpressive { namespace detail
         {
             sub_match_impl<BidiIter> &br = state.sub_match(this->mark_number_);
 
-            BidiIter old_begin = br.begin_;
-            br.begin_ = state.cur_;
+            sub_match_begin<BidiIter> old_begin = br.begin_;
+            br.begin_.set(state.cur_, state.begin_);
 
             if(next.match(state))
             {
@@ -42,7 +42,7 @@ namespace boost { namespace xpressive { namespace detail
             BidiIter old_second = br.second;
             bool old_matched = br.matched;
 
-            br.first = br.begin_;
+            br.first = br.begin_.get(state.begin_);
             br.second = state.cur_;
             br.matched = true;
 
@@ -41,9 +41,13 @@ namespace boost { namespace xpressive { namespace detail
         // we don't have to worry about it going away.
         regex_impl<BidiIter> const *pimpl_;
 
-        regex_byref_matcher(shared_ptr<regex_impl<BidiIter> > const &impl)
+        // whether to skip creating nested results for this invocation
+        bool nosubs_;
+
+        regex_byref_matcher(shared_ptr<regex_impl<BidiIter> > const &impl, bool nosubs = false)
           : wimpl_(impl)
           , pimpl_(impl.get())
+          , nosubs_(nosubs)
         {
             BOOST_ASSERT(this->pimpl_);
         }
@@ -54,7 +58,7 @@ namespace boost { namespace xpressive { namespace detail
             BOOST_ASSERT(this->pimpl_ == this->wimpl_.lock().get());
             BOOST_XPR_ENSURE_(this->pimpl_->xpr_, regex_constants::error_badref, "bad regex reference");
 
-            return push_context_match(*this->pimpl_, state, this->wrap_(next, is_static_xpression<Next>()));
+            return push_context_match(*this->pimpl_, state, this->wrap_(next, is_static_xpression<Next>()), this->nosubs_);
         }
 
     private:
@@ -34,8 +34,12 @@ namespace boost { namespace xpressive { namespace detail
     {
         regex_impl<BidiIter> impl_;
 
-        regex_matcher(shared_ptr<regex_impl<BidiIter> > const &impl)
+        // whether to skip creating nested results for this invocation
+        bool nosubs_;
+
+        regex_matcher(shared_ptr<regex_impl<BidiIter> > const &impl, bool nosubs = false)
           : impl_()
+          , nosubs_(nosubs)
         {
             this->impl_.xpr_ = impl->xpr_;
             this->impl_.traits_ = impl->traits_;
@@ -54,7 +58,7 @@ namespace boost { namespace xpressive { namespace detail
 
             // wrap the static xpression in a matchable interface
             xpression_adaptor<reference_wrapper<Next const>, matchable<BidiIter> > adaptor(boost::cref(next));
-            return push_context_match(this->impl_, state, adaptor);
+            return push_context_match(this->impl_, state, adaptor, this->nosubs_);
         }
     };
 
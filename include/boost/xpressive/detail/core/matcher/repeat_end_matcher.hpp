@@ -47,13 +47,13 @@ namespace boost { namespace xpressive { namespace detail
             // prevent repeated zero-width sub-matches from causing infinite recursion
             sub_match_impl<BidiIter> &br = state.sub_match(this->mark_number_);
 
-            if(br.zero_width_ && br.begin_ == state.cur_)
+            if(br.zero_width_ && br.begin_.get(state.begin_) == state.cur_)
             {
                 return next.skip_match(state);
             }
 
             bool old_zero_width = br.zero_width_;
-            br.zero_width_ = (br.begin_ == state.cur_);
+            br.zero_width_ = (br.begin_.get(state.begin_) == state.cur_);
 
             if(this->match_(state, next, greedy_type()))
             {
@@ -0,0 +1,147 @@
+///////////////////////////////////////////////////////////////////////////////
+// trie_matcher.hpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_XPRESSIVE_DETAIL_CORE_MATCHER_TRIE_MATCHER_HPP_EAN_10_04_2005
+#define BOOST_XPRESSIVE_DETAIL_CORE_MATCHER_TRIE_MATCHER_HPP_EAN_10_04_2005
+
+// MS compatible compilers support #pragma once
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+#include <map>
+#include <vector>
+#include <utility>
+#include <boost/mpl/bool.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/xpressive/detail/detail_fwd.hpp>
+#include <boost/xpressive/detail/core/quant_style.hpp>
+#include <boost/xpressive/detail/core/state.hpp>
+#include <boost/xpressive/detail/core/matcher/attr_matcher.hpp>
+#include <boost/xpressive/detail/utility/symbols.hpp>
+#include <boost/xpressive/detail/utility/traits_utils.hpp>
+
+namespace boost { namespace xpressive { namespace detail
+{
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // earliest_alternate
+    //  receives the strings that match at a position, and keeps the one that
+    //  was written first of those in alternates min_ and after.
+    template<typename BidiIter>
+    struct earliest_alternate
+    {
+        explicit earliest_alternate(std::size_t min)
+          : min_(min)
+          , alternate_(0)
+          , end_()
+        {
+        }
+
+        void operator()(std::size_t const *alternate, BidiIter end)
+        {
+            if(this->min_ <= *alternate && (0 == this->alternate_ || *alternate < *this->alternate_))
+            {
+                this->alternate_ = alternate;
+                this->end_ = end;
+            }
+        }
+
+        std::size_t min_;
+        std::size_t const *alternate_;
+        BidiIter end_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // trie_matcher
+    //  matches one of a list of alternate string literals. Like an alternation,
+    //  it tries the strings in the order they were written; unlike one, it finds
+    //  the strings that match by walking a trie, and doesn't look at the rest.
+    template<typename Traits, typename ICase>
+    struct trie_matcher
+      : quant_style_variable_width
+    {
+        typedef typename Traits::char_type char_type;
+        typedef typename Traits::string_type string_type;
+        typedef ICase icase_type;
+        typedef std::map<string_type, std::size_t> map_type;
+
+        trie_matcher(std::vector<string_type> const &strs, Traits const &tr)
+          : impl_()
+          , width_(strs.empty() ? 0 : strs.front().size())
+        {
+            shared_ptr<impl> p(new impl);
+            for(std::size_t i = 0; i < strs.size(); ++i)
+            {
+                string_type str(strs[i]);
+                for(std::size_t j = 0; j < str.size(); ++j)
+                {
+                    str[j] = detail::translate(str[j], tr, icase_type());
+                }
+
+                // a string written twice is found in the first alternate
+                p->map_.insert(std::make_pair(str, i));
+                this->width_ |= strs[i].size();
+            }
+            p->sym_.load(p->map_, char_translate<Traits, ICase::value>(tr));
+            this->impl_ = p;
+        }
+
+        template<typename BidiIter, typename Next>
+        bool match(match_state<BidiIter> &state, Next const &next) const
+        {
+            BidiIter const tmp = state.cur_;
+            char_translate<Traits, ICase::value> trans(traits_cast<Traits>(state));
+
+            // try the strings that match in the order they were written. Only
+            // when next fails is the trie walked again, for the next string.
+            for(std::size_t min = 0;;)
+            {
+                earliest_alternate<BidiIter> alt(min);
+                this->impl_->sym_.prefixes(tmp, state.end_, trans, alt);
+                if(0 == alt.alternate_)
+                {
+                    break;
+                }
+
+                state.cur_ = alt.end_;
+                if(next.match(state))
+                {
+                    return true;
+                }
+                min = *alt.alternate_ + 1;
+            }
+
+            state.cur_ = tmp;
+            return false;
+        }
+
+        template<typename Sink>
+        void peek(Sink const &sink) const
+        {
+            this->impl_->sym_.peek(sink);
+        }
+
+        detail::width get_width() const
+        {
+            return this->width_;
+        }
+
+    private:
+        struct impl
+        {
+            map_type map_;
+            symbols<map_type> sym_;
+        };
+
+        shared_ptr<impl const> impl_;
+        detail::width width_;
+    };
+
+}}}
+
+#endif
@@ -45,6 +45,7 @@
 #include <boost/xpressive/detail/core/matcher/set_matcher.hpp>
 #include <boost/xpressive/detail/core/matcher/simple_repeat_matcher.hpp>
 #include <boost/xpressive/detail/core/matcher/string_matcher.hpp>
+#include <boost/xpressive/detail/core/matcher/trie_matcher.hpp>
 #include <boost/xpressive/detail/core/matcher/true_matcher.hpp>
 
 #endif
@@ -0,0 +1,343 @@
+///////////////////////////////////////////////////////////////////////////////
+// memo_table.hpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_XPRESSIVE_DETAIL_CORE_MEMO_TABLE_HPP_EAN_10_04_2005
+#define BOOST_XPRESSIVE_DETAIL_CORE_MEMO_TABLE_HPP_EAN_10_04_2005
+
+// MS compatible compilers support #pragma once
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+#include <cstddef>
+#include <memory>
+#include <algorithm>
+#include <boost/assert.hpp>
+#include <boost/xpressive/xpressive_fwd.hpp>
+#include <boost/xpressive/detail/utility/byte_allocator.hpp>
+
+namespace boost { namespace xpressive { namespace detail
+{
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // memo_array
+    //   a growable array of offsets that never grows beyond a byte limit
+    struct memo_array
+    {
+        memo_array()
+          : data_(0)
+          , size_(0)
+          , capacity_(0)
+        {
+        }
+
+        std::size_t retained_bytes() const
+        {
+            return this->capacity_ * sizeof(std::ptrdiff_t);
+        }
+
+        // returns false if the array would grow beyond max_bytes
+        bool push_back(byte_allocator *alloc, std::ptrdiff_t value, std::size_t max_bytes)
+        {
+            if(this->size_ == this->capacity_)
+            {
+                std::size_t capacity = (std::max)(this->capacity_ * 2, std::size_t(64));
+                if(capacity * sizeof(std::ptrdiff_t) > max_bytes)
+                {
+                    return false;
+                }
+                std::ptrdiff_t *data = static_cast<std::ptrdiff_t *>(allocate_bytes(alloc, capacity * sizeof(std::ptrdiff_t)));
+                std::copy(this->data_, this->data_ + this->size_, data);
+                this->release(alloc);
+                this->data_ = data;
+                this->capacity_ = capacity;
+            }
+            this->data_[this->size_++] = value;
+            return true;
+        }
+
+        void release(byte_allocator *alloc)
+        {
+            if(0 != this->data_)
+            {
+                deallocate_bytes(alloc, this->data_, this->retained_bytes());
+                this->data_ = 0;
+                this->capacity_ = 0;
+            }
+        }
+
+        std::ptrdiff_t *data_;
+        std::size_t size_;
+        std::size_t capacity_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // memo_table
+    //   Remembers, for a nested regex and a position, every position at which
+    //   the nested regex can end, in the order that backtracking finds them. An
+    //   empty list means the nested regex can't match there at all. This is used
+    //   by match_memoize.
+    //
+    //   The entries are kept in an open-addressed hash table, stamped with a
+    //   generation so that clearing the table between matches is free. While a
+    //   nested regex is being matched, the ends found so far are kept on a stack;
+    //   they are copied into the table only once the nested regex has been
+    //   exhausted, at which point the list is known to be complete. The stack is
+    //   only emptied between matches.
+    struct memo_table
+    {
+        struct entry
+        {
+            std::size_t begin_;
+            std::size_t size_;
+        };
+
+        explicit memo_table(byte_allocator *alloc = 0)
+          : alloc_(alloc)
+          , slots_(0)
+          , capacity_(0)
+          , size_(0)
+          , generation_(1)
+          , ends_()
+          , stack_()
+        {
+        }
+
+        ~memo_table()
+        {
+            this->release();
+        }
+
+        std::size_t retained_bytes() const
+        {
+            return this->capacity_ * sizeof(slot) + this->ends_.retained_bytes() + this->stack_.retained_bytes();
+        }
+
+        // forgets all the entries, but keeps the memory
+        void clear()
+        {
+            this->size_ = 0;
+            this->ends_.size_ = 0;
+            this->stack_.size_ = 0;
+            if(0 == ++this->generation_)
+            {
+                std::fill(this->slots_, this->slots_ + this->capacity_, slot());
+                this->generation_ = 1;
+            }
+        }
+
+        // forgets all the entries and frees the memory
+        void release()
+        {
+            if(0 != this->slots_)
+            {
+                deallocate_bytes(this->alloc_, this->slots_, this->capacity_ * sizeof(slot));
+            }
+            this->slots_ = 0;
+            this->capacity_ = this->size_ = 0;
+            this->ends_.release(this->alloc_);
+            this->ends_.size_ = 0;
+            this->stack_.release(this->alloc_);
+            this->stack_.size_ = 0;
+        }
+
+        // the entry for the nested regex id at pos, or null if there is none
+        entry const *find(regex_id_type id, std::ptrdiff_t pos) const
+        {
+            if(0 != this->size_)
+            {
+                for(std::size_t i = this->hash_(id, pos);; i = (i + 1) & (this->capacity_ - 1))
+                {
+                    slot const &s = this->slots_[i];
+                    if(s.generation_ != this->generation_)
+                    {
+                        return 0;
+                    }
+                    else if(s.id_ == id && s.pos_ == pos)
+                    {
+                        return &s.entry_;
+                    }
+                }
+            }
+            return 0;
+        }
+
+        std::ptrdiff_t const *ends(entry const &e) const
+        {
+            return this->ends_.data_ + e.begin_;
+        }
+
+        // recorded(), record() and record_commit() collect the ends of a nested
+        // regex in a chain. The chains of nested regexes that are being matched
+        // at the same time are interleaved on the stack.
+        static std::size_t npos()
+        {
+            return static_cast<std::size_t>(-1);
+        }
+
+        struct chain
+        {
+            chain()
+              : head_(npos())
+              , size_(0)
+            {
+            }
+
+            std::size_t head_;
+            std::size_t size_;
+        };
+
+        // whether end is in c
+        bool recorded(chain const &c, std::ptrdiff_t end) const
+        {
+            for(std::size_t i = c.head_; npos() != i; i = this->link_(i))
+            {
+                if(this->stack_.data_[i] == end)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // adds end to c, or returns false if that would exceed max_bytes
+        bool record(chain &c, std::ptrdiff_t end, std::size_t max_bytes)
+        {
+            std::size_t const size = this->stack_.size_;
+            if(!this->stack_.push_back(this->alloc_, end, max_bytes) ||
+               !this->stack_.push_back(this->alloc_, static_cast<std::ptrdiff_t>(c.head_), max_bytes))
+            {
+                this->stack_.size_ = size;
+                return false;
+            }
+            c.head_ = size;
+            ++c.size_;
+            return true;
+        }
+
+        // makes a new entry for the nested regex id at pos with the ends in c,
+        // unless that would exceed max_bytes
+        void record_commit(regex_id_type id, std::ptrdiff_t pos, chain const &c, std::size_t max_bytes)
+        {
+            entry e = {this->ends_.size_, c.size_};
+            for(std::size_t i = 0; i != c.size_; ++i)
+            {
+                if(!this->ends_.push_back(this->alloc_, 0, max_bytes))
+                {
+                    this->ends_.size_ = e.begin_;
+                    return;
+                }
+            }
+
+            // the chain runs from the last end to the first
+            std::ptrdiff_t *out = this->ends_.data_ + this->ends_.size_;
+            for(std::size_t i = c.head_; npos() != i; i = this->link_(i))
+            {
+                *--out = this->stack_.data_[i];
+            }
+
+            // keep the table at most half full
+            if(2 * (this->size_ + 1) > this->capacity_)
+            {
+                std::size_t capacity = (std::max)(this->capacity_ * 2, std::size_t(64));
+                if(capacity * sizeof(slot) > max_bytes)
+                {
+                    this->ends_.size_ = e.begin_;
+                    return;
+                }
+                this->grow_(capacity);
+            }
+
+            this->insert_(id, pos, e);
+        }
+
+    private:
+        struct slot
+        {
+            slot()
+              : id_(0)
+              , pos_(0)
+              , generation_(0)
+            {
+                this->entry_.begin_ = this->entry_.size_ = 0;
+            }
+
+            regex_id_type id_;
+            std::ptrdiff_t pos_;
+            std::size_t generation_;
+            entry entry_;
+        };
+
+        memo_table(memo_table const &);
+        memo_table &operator =(memo_table const &);
+
+        std::size_t link_(std::size_t i) const
+        {
+            return static_cast<std::size_t>(this->stack_.data_[i + 1]);
+        }
+
+        std::size_t hash_(regex_id_type id, std::ptrdiff_t pos) const
+        {
+            std::size_t h = reinterpret_cast<std::size_t>(id) / sizeof(void *);
+            h ^= static_cast<std::size_t>(pos) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            return (h * 0x9e3779b9) & (this->capacity_ - 1);
+        }
+
+        void insert_(regex_id_type id, std::ptrdiff_t pos, entry const &e)
+        {
+            std::size_t i = this->hash_(id, pos);
+            for(; this->slots_[i].generation_ == this->generation_; i = (i + 1) & (this->capacity_ - 1))
+            {
+                BOOST_ASSERT(this->slots_[i].id_ != id || this->slots_[i].pos_ != pos);
+            }
+            slot &s = this->slots_[i];
+            s.id_ = id;
+            s.pos_ = pos;
+            s.generation_ = this->generation_;
+            s.entry_ = e;
+            ++this->size_;
+        }
+
+        void grow_(std::size_t capacity)
+        {
+            BOOST_ASSERT(0 == (capacity & (capacity - 1)));
+            slot *old_slots = this->slots_;
+            std::size_t old_capacity = this->capacity_;
+
+            this->slots_ = static_cast<slot *>(allocate_bytes(this->alloc_, capacity * sizeof(slot)));
+            std::uninitialized_fill(this->slots_, this->slots_ + capacity, slot());
+            this->capacity_ = capacity;
+            this->size_ = 0;
+
+            std::size_t generation = this->generation_;
+            this->generation_ = 1;
+            for(std::size_t i = 0; i < old_capacity; ++i)
+            {
+                if(old_slots[i].generation_ == generation)
+                {
+                    this->insert_(old_slots[i].id_, old_slots[i].pos_, old_slots[i].entry_);
+                }
+            }
+
+            if(0 != old_slots)
+            {
+                deallocate_bytes(this->alloc_, old_slots, old_capacity * sizeof(slot));
+            }
+        }
+
+        byte_allocator *alloc_;
+        slot *slots_;
+        std::size_t capacity_;
+        std::size_t size_;
+        std::size_t generation_;
+        memo_array ends_;
+        memo_array stack_;
+    };
+
+}}} // namespace boost::xpressive::detail
+
+#endif
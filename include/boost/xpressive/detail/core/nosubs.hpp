@@ -0,0 +1,43 @@
+///////////////////////////////////////////////////////////////////////////////
+// nosubs.hpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_XPRESSIVE_DETAIL_CORE_NOSUBS_HPP_EAN_10_04_2005
+#define BOOST_XPRESSIVE_DETAIL_CORE_NOSUBS_HPP_EAN_10_04_2005
+
+#include <boost/xpressive/detail/detail_fwd.hpp>
+#include <boost/xpressive/regex_constants.hpp>
+#include <boost/xpressive/detail/static/modifier.hpp>
+#include <boost/xpressive/detail/core/linker.hpp>
+#include <boost/xpressive/detail/utility/ignore_unused.hpp>
+
+namespace boost { namespace xpressive { namespace regex_constants
+{
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Keeps nested regexes from creating nested results.
+///
+/// Use nosubs() around a sub-expression that invokes other regexes, when the
+/// results of those invocations are not needed. For instance, in
+/// word >> *(' ' >> nosubs(word)), only the first word is added to the nested
+/// results. Nested regexes invoked this way are cheaper to match.
+detail::modifier_op<detail::nosubs_modifier> const nosubs = {{}, regex_constants::nosubs_};
+
+} // namespace regex_constants
+
+using regex_constants::nosubs;
+
+namespace detail
+{
+    inline void ignore_unused_nosubs()
+    {
+        detail::ignore_unused(nosubs);
+    }
+}
+
+}} // namespace boost::xpressive
+
+#endif
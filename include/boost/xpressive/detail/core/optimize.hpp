@@ -10,17 +10,80 @@
 
 #include <string>
 #include <utility>
+#include <boost/mpl/or.hpp>
+#include <boost/mpl/and.hpp>
 #include <boost/mpl/bool.hpp>
 #include <boost/intrusive_ptr.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/begin.hpp>
 #include <boost/iterator/iterator_traits.hpp>
+#include <boost/type_traits/is_same.hpp>
 #include <boost/xpressive/detail/core/finder.hpp>
 #include <boost/xpressive/detail/core/linker.hpp>
 #include <boost/xpressive/detail/core/peeker.hpp>
 #include <boost/xpressive/detail/core/regex_impl.hpp>
+#include <boost/xpressive/detail/static/type_traits.hpp>
 
 namespace boost { namespace xpressive { namespace detail
 {
 
+///////////////////////////////////////////////////////////////////////////////
+// use_memchr
+//   memchr can find a leading char if the input is a contiguous sequence of
+//   chars and the traits compare characters as they are.
+template<typename BidiIter, typename Traits>
+struct use_memchr
+  : mpl::and_<
+        is_contiguous<BidiIter>
+      , is_same<typename iterator_value<BidiIter>::type, char>
+      , mpl::or_<
+            is_same<Traits, regex_traits<char, cpp_regex_traits<char> > >
+          , is_same<Traits, regex_traits<char, c_regex_traits<char> > >
+          , is_same<Traits, cpp_regex_traits<char> >
+          , is_same<Traits, c_regex_traits<char> >
+        >
+    >
+{
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// optimize_peek
+//
+template<typename BidiIter, typename Traits>
+intrusive_ptr<finder<BidiIter> > optimize_peek
+(
+    hash_peek_bitset<typename iterator_value<BidiIter>::type> const &bset
+  , mpl::false_
+)
+{
+    return intrusive_ptr<finder<BidiIter> >
+    (
+        new hash_peek_finder<BidiIter, Traits>(bset)
+    );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// optimize_peek
+//
+template<typename BidiIter, typename Traits>
+intrusive_ptr<finder<BidiIter> > optimize_peek
+(
+    hash_peek_bitset<char> const &bset
+  , mpl::true_
+)
+{
+    // the builtin traits hash a char to itself, as an unsigned char
+    if(!bset.icase() && 1 == bset.count())
+    {
+        return intrusive_ptr<finder<BidiIter> >
+        (
+            new memchr_finder<BidiIter>(static_cast<char>(static_cast<unsigned char>(bset.only_hash())))
+        );
+    }
+
+    return optimize_peek<BidiIter, Traits>(bset, mpl::false_());
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // optimize_regex
 //
@@ -48,10 +111,7 @@ intrusive_ptr<finder<BidiIter> > optimize_regex
     }
     else if(256 != peeker.bitset().count())
     {
-        return intrusive_ptr<finder<BidiIter> >
-        (
-            new hash_peek_finder<BidiIter, Traits>(peeker.bitset())
-        );
+        return optimize_peek<BidiIter, Traits>(peeker.bitset(), use_memchr<BidiIter, Traits>());
     }
 
     return intrusive_ptr<finder<BidiIter> >();
@@ -109,6 +169,26 @@ void common_compile
     // optimization: get the peek chars OR the boyer-moore search string
     impl.finder_ = optimize_regex<BidiIter>(peeker, tr, is_random<BidiIter>());
     impl.xpr_ = regex;
+    impl.literal_.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// optimize_literal
+//   Called after common_compile when the whole regex is a case-sensitive
+//   string with no marks or assertions. regex_replace can then search for the
+//   string with memchr and memcmp, provided the traits don't translate chars.
+template<typename BidiIter, typename Traits>
+void optimize_literal
+(
+    regex_impl<BidiIter> &impl
+  , typename Traits::string_type const &literal
+  , Traits const &
+)
+{
+    if(use_memchr<BidiIter, Traits>::value)
+    {
+        impl.literal_.assign(boost::begin(literal), boost::end(literal));
+    }
 }
 
 }}} // namespace boost::xpressive
@@ -159,6 +159,13 @@ struct xpression_peeker
         return mpl::false_();
     }
 
+    template<typename Traits, typename ICase>
+    mpl::false_ accept(trie_matcher<Traits, ICase> const &xpr)
+    {
+        xpr.peek(char_sink<Traits, ICase::value>(this->bset_, this->get_traits_<Traits>()));
+        return mpl::false_();
+    }
+
     template<typename Alternates, typename Traits>
     mpl::false_ accept(alternate_matcher<Alternates, Traits> const &xpr)
     {
@@ -174,6 +181,20 @@ struct xpression_peeker
         return mpl::false_();
     }
 
+    template<typename Map, typename Traits, typename ICase>
+    mpl::false_ accept(attr_matcher<symbol_table<Map>, Traits, ICase> const &)
+    {
+        this->fail();  // the keys can change
+        return mpl::false_();
+    }
+
+    template<typename Value, typename Traits, typename ICase>
+    mpl::false_ accept(attr_matcher<mapped_symbols<Char, Value>, Traits, ICase> const &xpr)
+    {
+        xpr.sym_.peek(this->bset_, this->get_traits_<Traits>());
+        return mpl::false_();
+    }
+
     template<typename Xpr, typename Greedy>
     mpl::false_ accept(optional_matcher<Xpr, Greedy> const &)
     {
@@ -13,7 +13,10 @@
 # pragma once
 #endif
 
+#include <string>
 #include <vector>
+#include <iterator>
+#include <algorithm>
 #include <boost/intrusive_ptr.hpp>
 #include <boost/xpressive/regex_traits.hpp>
 #include <boost/xpressive/detail/detail_fwd.hpp>
@@ -64,6 +67,81 @@ struct named_mark
     std::size_t mark_nbr_;
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// named_marks
+//   The named marks of a regex, sorted by name so that a look-up is a binary
+//   search. Once the regex is compiled, it is shared with every match_results
+//   object that is used with the regex.
+template<typename Char>
+struct named_marks
+  : counted_base<named_marks<Char> >
+{
+    typedef typename detail::string_type<Char>::type string_type;
+
+    // returns false if there is already a mark with that name
+    bool insert(string_type const &name, std::size_t mark_nbr)
+    {
+        std::size_t where = this->lower_bound_(name.begin(), name.end());
+        if(where != this->marks_.size() && equal_(this->marks_[where], name.begin(), name.end()))
+        {
+            return false;
+        }
+        this->marks_.insert(this->marks_.begin() + where, named_mark<Char>(name, mark_nbr));
+        return true;
+    }
+
+    // the mark named [begin, end), or null if there is none
+    template<typename FwdIter>
+    named_mark<Char> const *find(FwdIter begin, FwdIter end) const
+    {
+        std::size_t where = this->lower_bound_(begin, end);
+        return (where != this->marks_.size() && equal_(this->marks_[where], begin, end))
+            ? &this->marks_[where]
+            : 0;
+    }
+
+    // the mark named by the null-terminated string name, or null if there is none
+    named_mark<Char> const *find(Char const *name) const
+    {
+        Char const *end = name;
+        for(; Char() != *end; ++end)
+        {}
+        return this->find(name, end);
+    }
+
+private:
+    // the index of the first mark whose name is not less than [begin, end)
+    template<typename FwdIter>
+    std::size_t lower_bound_(FwdIter begin, FwdIter end) const
+    {
+        std::size_t first = 0, count = this->marks_.size();
+        while(0 != count)
+        {
+            std::size_t half = count / 2;
+            string_type const &name = this->marks_[first + half].name_;
+            if(std::lexicographical_compare(name.begin(), name.end(), begin, end))
+            {
+                first += half + 1;
+                count -= half + 1;
+            }
+            else
+            {
+                count = half;
+            }
+        }
+        return first;
+    }
+
+    template<typename FwdIter>
+    static bool equal_(named_mark<Char> const &mark, FwdIter begin, FwdIter end)
+    {
+        return static_cast<std::size_t>(std::distance(begin, end)) == mark.name_.size()
+            && std::equal(mark.name_.begin(), mark.name_.end(), begin);
+    }
+
+    std::vector<named_mark<Char> > marks_;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // traits_holder
 template<typename Traits>
@@ -141,6 +219,7 @@ struct regex_impl
       , traits_()
       , finder_()
       , named_marks_()
+      , literal_()
       , mark_count_(0)
       , hidden_mark_count_(0)
     {
@@ -155,6 +234,7 @@ struct regex_impl
       , traits_(that.traits_)
       , finder_(that.finder_)
       , named_marks_(that.named_marks_)
+      , literal_(that.literal_)
       , mark_count_(that.mark_count_)
       , hidden_mark_count_(that.hidden_mark_count_)
     {
@@ -177,6 +257,7 @@ struct regex_impl
         this->traits_.swap(that.traits_);
         this->finder_.swap(that.finder_);
         this->named_marks_.swap(that.named_marks_);
+        this->literal_.swap(that.literal_);
         std::swap(this->mark_count_, that.mark_count_);
         std::swap(this->hidden_mark_count_, that.hidden_mark_count_);
     }
@@ -184,7 +265,8 @@ struct regex_impl
     intrusive_ptr<matchable_ex<BidiIter> const> xpr_;
     intrusive_ptr<traits<char_type> const> traits_;
     intrusive_ptr<finder<BidiIter> > finder_;
-    std::vector<named_mark<char_type> > named_marks_;
+    intrusive_ptr<named_marks<char_type> > named_marks_;
+    typename string_type<char_type>::type literal_;
     std::size_t mark_count_;
     std::size_t hidden_mark_count_;
 
@@ -33,6 +33,10 @@ namespace boost { namespace xpressive { namespace detail
     {
         friend struct results_cache<BidiIter>;
         friend struct match_results<BidiIter>;
+
+        explicit nested_results(byte_allocator *alloc = 0)
+          : detail::list<match_results<BidiIter> >(alloc)
+        {}
     };
     #else
     template<typename BidiIter>
@@ -43,6 +47,10 @@ namespace boost { namespace xpressive { namespace detail
         friend struct xpressive::match_results<BidiIter>;
         typedef list<xpressive::match_results<BidiIter> > base_type;
 
+        explicit nested_results(byte_allocator *alloc = 0)
+          : base_type(alloc)
+        {}
+
         typedef typename base_type::iterator iterator;
         typedef typename base_type::const_iterator const_iterator;
         typedef typename base_type::pointer pointer;
@@ -56,6 +64,8 @@ namespace boost { namespace xpressive { namespace detail
         using base_type::empty;
         using base_type::front;
         using base_type::back;
+        using base_type::get_allocator;
+        using base_type::node_size;
     };
     #endif
 
@@ -68,16 +78,40 @@ namespace boost { namespace xpressive { namespace detail
     {
         typedef core_access<BidiIter> access;
 
+        explicit results_cache(byte_allocator *alloc = 0)
+          : cache_(alloc)
+          , count_(0)
+        {
+        }
+
+        // the number of bytes held by cached match_results structs
+        std::size_t retained_bytes() const
+        {
+            return this->count_ * nested_results<BidiIter>::node_size();
+        }
+
+        // free cached match_results structs until no more than max_bytes remain
+        void trim(std::size_t max_bytes)
+        {
+            for(; this->retained_bytes() > max_bytes; --this->count_)
+            {
+                this->cache_.pop_back();
+            }
+        }
+
         match_results<BidiIter> &append_new(nested_results<BidiIter> &out)
         {
             if(this->cache_.empty())
             {
-                out.push_back(match_results<BidiIter>());
+                // construct the new match_results in place, drawing from the same allocator
+                BOOST_ASSERT(out.get_allocator() == this->cache_.get_allocator());
+                out.push_back(this->cache_.get_allocator());
             }
             else
             {
                 BOOST_ASSERT(access::get_nested_results(this->cache_.back()).empty());
                 out.splice(out.end(), this->cache_, --this->cache_.end());
+                --this->count_;
             }
             return out.back();
         }
@@ -94,6 +128,7 @@ namespace boost { namespace xpressive { namespace detail
             }
             // then, reclaim the last match_results
             this->cache_.splice(this->cache_.end(), out, --out.end());
+            ++this->count_;
         }
 
         // move the last n match_results structs into the cache
@@ -110,7 +145,7 @@ namespace boost { namespace xpressive { namespace detail
             typedef typename nested_results<BidiIter>::iterator iter_type;
 
             // first, recursively reclaim all the nested results
-            for(iter_type begin = out.begin(); begin != out.end(); ++begin)
+            for(iter_type begin = out.begin(); begin != out.end(); ++begin, ++this->count_)
             {
                 nested_results<BidiIter> &nested = access::get_nested_results(*begin);
 
@@ -127,6 +162,7 @@ namespace boost { namespace xpressive { namespace detail
     private:
 
         nested_results<BidiIter> cache_;
+        std::size_t count_;
     };
 
 }}} // namespace boost::xpressive::detail
@@ -13,7 +13,15 @@
 # pragma once
 #endif
 
+#include <climits>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
 #include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/iterator/iterator_traits.hpp>
+#include <boost/type_traits/is_convertible.hpp>
 #include <boost/xpressive/detail/detail_fwd.hpp>
 #include <boost/xpressive/detail/core/access.hpp>
 #include <boost/xpressive/detail/core/action.hpp>
@@ -25,6 +33,25 @@
 namespace boost { namespace xpressive { namespace detail
 {
 
+///////////////////////////////////////////////////////////////////////////////
+// memo_record
+//   what match_memoize records about a nested regex while it is being matched
+struct memo_record
+{
+    // its ends so far, on the memo table's stack
+    memo_table::chain ends_;
+
+    // how many nested results and queued actions there were before it started
+    std::size_t nested_results_count_;
+    actionable const **action_list_tail_;
+
+    // whether moving the position is all it has done
+    bool replayable_;
+
+    // whether all its ends have been recorded
+    bool complete_;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // match_context
 //
@@ -38,6 +65,10 @@ struct match_context
       , prev_context_(0)
       , next_ptr_(0)
       , traits_(0)
+      , sub_matches_(0)
+      , mark_count_(0)
+      , regex_id_(0)
+      , memo_record_(0)
     {
     }
 
@@ -52,6 +83,16 @@ struct match_context
 
     // A pointer to the current traits object
     detail::traits<char_type> const *traits_;
+
+    // The sub-matches of the regex this context belongs to, and how many there are
+    sub_match_impl<BidiIter> *sub_matches_;
+    std::size_t mark_count_;
+
+    // The regex this context belongs to
+    regex_id_type regex_id_;
+
+    // With match_memoize, what is being recorded about this nested match
+    memo_record *memo_record_;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -80,6 +121,7 @@ struct match_flags
     bool match_not_null_;
     bool match_continuous_;
     bool match_partial_;
+    bool match_memoize_;
 
     explicit match_flags(regex_constants::match_flag_type flags)
       : match_all_(false)
@@ -91,6 +133,7 @@ struct match_flags
       , match_not_null_(0 != (flags & regex_constants::match_not_null))
       , match_continuous_(0 != (flags & regex_constants::match_continuous))
       , match_partial_(0 != (flags & regex_constants::match_partial))
+      , match_memoize_(0 != (flags & regex_constants::match_memoize) && !match_partial_)
     {
     }
 };
@@ -128,6 +171,7 @@ struct match_state
     action_args_type *action_args_;
     attr_context attr_context_;
     BidiIter next_search_;
+    std::vector<std::pair<void const *, shared_ptr<void const> > > pins_;
 
     ///////////////////////////////////////////////////////////////////////////////
     //
@@ -153,6 +197,7 @@ struct match_state
       , action_args_(&core_access<BidiIter>::get_action_args(what))
       , attr_context_() // zero-initializes the fields of attr_context_
       , next_search_(begin)
+      , pins_()
     {
         // reclaim any cached memory in the match_results struct
         this->extras_->sub_match_stack_.unwind();
@@ -162,6 +207,10 @@ struct match_state
 
         // move all the nested match_results structs into the match_results cache
         this->extras_->results_cache_.reclaim_all(access::get_nested_results(what));
+        this->extras_->memo_.clear();
+
+        // give back cached memory beyond the limit
+        this->extras_->trim();
     }
 
     ///////////////////////////////////////////////////////////////////////////////
@@ -173,11 +222,32 @@ struct match_state
         this->action_list_tail_ = &action_list_.next;
         this->action_args_ = &core_access<BidiIter>::get_action_args(what);
         this->attr_context_ = attr_context();
+        this->pins_.clear();
         this->context_.prev_context_ = 0;
         this->found_partial_match_ = false;
         this->extras_->sub_match_stack_.unwind();
         this->init_(impl, what);
         this->extras_->results_cache_.reclaim_all(access::get_nested_results(what));
+        this->extras_->memo_.clear();
+        this->extras_->trim();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // restart
+    //  re-target the state object at a new sequence without reconstructing it
+    void restart
+    (
+        BidiIter begin
+      , BidiIter end
+      , match_results &what
+      , regex_impl const &impl
+      , regex_constants::match_flag_type flags
+    )
+    {
+        this->cur_ = this->begin_ = this->next_search_ = begin;
+        this->end_ = end;
+        this->flags_ = match_flags(flags);
+        this->reset(what, impl);
     }
 
     ///////////////////////////////////////////////////////////////////////////////
@@ -200,7 +270,29 @@ struct match_state
         this->context_.next_ptr_ = &next;
 
         // record the start of the zero-th sub-match
-        this->sub_matches_[0].begin_ = this->cur_;
+        this->sub_matches_[0].begin_.set(this->cur_, this->begin_);
+
+        return context;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // push_nosubs_context
+    //  like push_context, but for a nested regex whose results are not kept. It
+    //  gets sub-matches of its own but shares the enclosing match_results.
+    match_context push_nosubs_context(regex_impl const &impl, matchable const &next, match_context &prev)
+    {
+        // save state
+        match_context context = this->context_;
+
+        // (re)initialize the match context
+        this->init_context_(impl);
+
+        // create a linked list of match_context structs
+        this->context_.prev_context_ = &prev;
+        this->context_.next_ptr_ = &next;
+
+        // record the start of the zero-th sub-match
+        this->sub_matches_[0].begin_.set(this->cur_, this->begin_);
 
         return context;
     }
@@ -213,19 +305,21 @@ struct match_state
         match_context &context = *this->context_.prev_context_;
         if(!success)
         {
-            match_results &what = *context.results_ptr_;
-            this->uninit_(impl, what);
-
-            // send the match_results struct back to the cache
-            nested_results<BidiIter> &nested = access::get_nested_results(what);
-            this->extras_->results_cache_.reclaim_last(nested);
+            this->uninit_(impl);
+
+            // send the match_results struct back to the cache, unless this
+            // nested regex shared the enclosing one
+            if(context.results_ptr_ != this->context_.results_ptr_)
+            {
+                nested_results<BidiIter> &nested = access::get_nested_results(*context.results_ptr_);
+                this->extras_->results_cache_.reclaim_last(nested);
+            }
         }
 
         // restore the state
         this->context_ = context;
-        match_results &results = *this->context_.results_ptr_;
-        this->sub_matches_ = access::get_sub_matches(access::get_sub_match_vector(results));
-        this->mark_count_ = results.size();
+        this->sub_matches_ = this->context_.sub_matches_;
+        this->mark_count_ = this->context_.mark_count_;
         return success;
     }
 
@@ -234,9 +328,8 @@ struct match_state
     void swap_context(match_context &context)
     {
         std::swap(this->context_, context);
-        match_results &results = *this->context_.results_ptr_;
-        this->sub_matches_ = access::get_sub_matches(access::get_sub_match_vector(results));
-        this->mark_count_ = results.size();
+        this->sub_matches_ = this->context_.sub_matches_;
+        this->mark_count_ = this->context_.mark_count_;
     }
 
     // beginning of buffer
@@ -254,7 +347,48 @@ struct match_state
     // is this the regex that is currently executing?
     bool is_active_regex(regex_impl const &impl) const
     {
-        return impl.xpr_.get() == this->context_.results_ptr_->regex_id();
+        return impl.xpr_.get() == this->context_.regex_id_;
+    }
+
+    // whether to remember where nested regexes failed to match
+    bool memoize() const
+    {
+        typedef typename iterator_category<BidiIter>::type category;
+        return is_convertible<category, std::random_access_iterator_tag>::value && this->flags_.match_memoize_;
+    }
+
+    // the offset of the current position, for the memo table
+    std::ptrdiff_t position() const
+    {
+        return std::distance(this->begin_, this->cur_);
+    }
+
+    // moves to the position at offset pos
+    void position(std::ptrdiff_t pos)
+    {
+        this->cur_ = this->begin_;
+        std::advance(this->cur_, pos);
+    }
+
+    // what was pinned under key during this search, or 0 if nothing was
+    shared_ptr<void const> const *find_pin(void const *key) const
+    {
+        for(std::size_t i = 0; i < this->pins_.size(); ++i)
+        {
+            if(key == this->pins_[i].first)
+            {
+                return &this->pins_[i].second;
+            }
+        }
+        return 0;
+    }
+
+    // keeps p alive until the search is over, so that attributes and queued
+    // actions may point into it after the matcher that pinned it has returned
+    shared_ptr<void const> const &pin(void const *key, shared_ptr<void const> const &p)
+    {
+        this->pins_.push_back(std::make_pair(key, p));
+        return this->pins_.back().second;
     }
 
     // fetch the n-th sub_match
@@ -267,7 +401,7 @@ struct match_state
     void set_partial_match()
     {
         sub_match_impl &sub0 = this->sub_match(0);
-        sub0.first = sub0.begin_;
+        sub0.first = sub0.begin_.get(this->begin_);
         sub0.second = this->end_;
         sub0.matched = false;
     }
@@ -282,21 +416,29 @@ private:
 
     void init_(regex_impl const &impl, match_results &what)
     {
-        regex_id_type const id = impl.xpr_.get();
-        std::size_t const total_mark_count = impl.mark_count_ + impl.hidden_mark_count_ + 1;
-
         // initialize the context and the sub_match vector
         this->context_.results_ptr_ = &what;
+        this->init_context_(impl);
+
+        // initialize the match_results struct
+        access::init_match_results(what, impl.xpr_.get(), impl.traits_, this->sub_matches_, this->mark_count_, impl.named_marks_);
+    }
+
+    void init_context_(regex_impl const &impl)
+    {
+        std::size_t const total_mark_count = impl.mark_count_ + impl.hidden_mark_count_ + 1;
+
         this->context_.traits_ = impl.traits_.get();
+        this->context_.regex_id_ = impl.xpr_.get();
         this->mark_count_ = impl.mark_count_ + 1;
         this->sub_matches_ = this->extras_->sub_match_stack_.push_sequence(total_mark_count, sub_match_impl(begin_), detail::fill);
         this->sub_matches_ += impl.hidden_mark_count_;
-
-        // initialize the match_results struct
-        access::init_match_results(what, id, impl.traits_, this->sub_matches_, this->mark_count_, impl.named_marks_);
+        this->context_.sub_matches_ = this->sub_matches_;
+        this->context_.mark_count_ = this->mark_count_;
+        this->context_.memo_record_ = 0;
     }
 
-    void uninit_(regex_impl const &impl, match_results &)
+    void uninit_(regex_impl const &impl)
     {
         extras_->sub_match_stack_.unwind_to(this->sub_matches_ - impl.hidden_mark_count_);
     }
@@ -308,6 +450,22 @@ private:
     }
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// mark_range
+//   The sub-matches [begin_, end_) that an independent sub-expression can
+//   write. The linker narrows it; until then, it covers them all.
+struct mark_range
+{
+    mark_range(int begin = 0, int end = INT_MAX)
+      : begin_(begin)
+      , end_(end)
+    {
+    }
+
+    int begin_;
+    int end_;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // memento
 //
@@ -315,6 +473,8 @@ template<typename BidiIter>
 struct memento
 {
     sub_match_impl<BidiIter> *old_sub_matches_;
+    std::size_t marks_begin_;
+    std::size_t marks_end_;
     std::size_t nested_results_count_;
     actionable const *action_list_head_;
     actionable const **action_list_tail_;
@@ -324,12 +484,19 @@ struct memento
 ///////////////////////////////////////////////////////////////////////////////
 // save_sub_matches
 //
+//   Only the sub-matches in marks are saved, since matching the sub-expression
+//   leaves the others alone. At least one slot is pushed so that the position
+//   of the saved block on the stack is always a valid place to unwind to.
 template<typename BidiIter>
-inline memento<BidiIter> save_sub_matches(match_state<BidiIter> &state)
+inline memento<BidiIter> save_sub_matches(match_state<BidiIter> &state, mark_range const &marks = mark_range())
 {
+    std::size_t end = (std::min)(static_cast<std::size_t>(marks.end_), state.mark_count_);
+    std::size_t begin = (std::min)(static_cast<std::size_t>(marks.begin_), end);
     memento<BidiIter> mem =
     {
-        state.extras_->sub_match_stack_.push_sequence(state.mark_count_, sub_match_impl<BidiIter>(state.begin_))
+        state.extras_->sub_match_stack_.push_sequence((std::max)(end - begin, std::size_t(1)), sub_match_impl<BidiIter>(state.begin_))
+      , begin
+      , end
       , state.context_.results_ptr_->nested_results().size()
       , state.action_list_.next
       , state.action_list_tail_
@@ -337,7 +504,7 @@ inline memento<BidiIter> save_sub_matches(match_state<BidiIter> &state)
     };
     state.action_list_.next = 0;
     state.action_list_tail_ = &state.action_list_.next;
-    std::copy(state.sub_matches_, state.sub_matches_ + state.mark_count_, mem.old_sub_matches_);
+    std::copy(state.sub_matches_ + begin, state.sub_matches_ + end, mem.old_sub_matches_);
     return mem;
 }
 
@@ -362,7 +529,7 @@ inline void restore_sub_matches(memento<BidiIter> const &mem, match_state<BidiIt
     nested_results<BidiIter> &nested = access::get_nested_results(*state.context_.results_ptr_);
     std::size_t count = nested.size() - mem.nested_results_count_;
     state.extras_->results_cache_.reclaim_last_n(nested, count);
-    std::copy(mem.old_sub_matches_, mem.old_sub_matches_ + state.mark_count_, state.sub_matches_);
+    std::copy(mem.old_sub_matches_, mem.old_sub_matches_ + (mem.marks_end_ - mem.marks_begin_), state.sub_matches_ + mem.marks_begin_);
     state.extras_->sub_match_stack_.unwind_to(mem.old_sub_matches_);
     state.attr_context_ = mem.attr_context_;
 }
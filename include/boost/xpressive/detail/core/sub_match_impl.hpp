@@ -13,7 +13,10 @@
 # pragma once
 #endif
 
+#include <cstddef>
+#include <boost/iterator/iterator_traits.hpp>
 #include <boost/xpressive/sub_match.hpp>
+#include <boost/xpressive/detail/static/type_traits.hpp>
 
 namespace boost { namespace xpressive { namespace detail
 {
@@ -22,6 +25,58 @@ namespace boost { namespace xpressive { namespace detail
 // of them can be made more efficient if they are. Or maybe all they
 // need is trivial constructor/destructor. (???)
 
+///////////////////////////////////////////////////////////////////////////////
+// sub_match_begin
+//   Where a sub-match began, relative to base, the start of the input being
+//   searched. Random-access iterators that are bigger than an offset, like
+//   std::deque's, are kept as the offset from base.
+template<
+    typename BidiIter
+  , bool Offset = is_random<BidiIter>::value && (sizeof(std::ptrdiff_t) < sizeof(BidiIter))
+>
+struct sub_match_begin
+{
+    explicit sub_match_begin(BidiIter const &base)
+      : it_(base)
+    {
+    }
+
+    BidiIter get(BidiIter const &) const
+    {
+        return this->it_;
+    }
+
+    void set(BidiIter const &it, BidiIter const &)
+    {
+        this->it_ = it;
+    }
+
+private:
+    BidiIter it_;
+};
+
+template<typename BidiIter>
+struct sub_match_begin<BidiIter, true>
+{
+    explicit sub_match_begin(BidiIter const &)
+      : off_(0)
+    {
+    }
+
+    BidiIter get(BidiIter const &base) const
+    {
+        return base + this->off_;
+    }
+
+    void set(BidiIter const &it, BidiIter const &base)
+    {
+        this->off_ = it - base;
+    }
+
+private:
+    typename iterator_difference<BidiIter>::type off_;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // sub_match_impl
 //
@@ -29,15 +84,18 @@ template<typename BidiIter>
 struct sub_match_impl
   : sub_match<BidiIter>
 {
-    unsigned int repeat_count_;
-    BidiIter begin_;
+    // The small members come first so they can share the tail padding
+    // after sub_match::matched; the whole thing is copied on every save.
     bool zero_width_;
+    unsigned int repeat_count_;
+    sub_match_begin<BidiIter> begin_;
 
-    sub_match_impl(BidiIter const &begin)
-      : sub_match<BidiIter>(begin, begin)
-      , repeat_count_(0)
-      , begin_(begin)
+    // base is the start of the input
+    sub_match_impl(BidiIter const &base)
+      : sub_match<BidiIter>(base, base)
       , zero_width_(false)
+      , repeat_count_(0)
+      , begin_(base)
     {
     }
 };
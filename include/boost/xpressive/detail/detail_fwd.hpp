@@ -36,9 +36,9 @@ namespace boost { namespace xpressive { namespace detail
 
     typedef mpl::size_t<INT_MAX / 2 - 1> unknown_width;
 
-    struct type_info_less;
+    struct action_args;
 
-    typedef std::map<std::type_info const *, void *, type_info_less> action_args_type;
+    typedef action_args action_args_type;
 
     struct action_context;
 
@@ -140,6 +140,9 @@ namespace boost { namespace xpressive { namespace detail
     template<typename Traits, typename ICase>
     struct string_matcher;
 
+    template<typename Traits, typename ICase>
+    struct trie_matcher;
+
     template<typename Actor>
     struct action_matcher;
 
@@ -171,6 +174,8 @@ namespace boost { namespace xpressive { namespace detail
 
     struct icase_modifier;
 
+    struct nosubs_modifier;
+
     template<typename BidiIter, typename ICase, typename Traits>
     struct xpression_visitor;
 
@@ -321,6 +326,9 @@ namespace boost { namespace xpressive { namespace detail
     template<typename Char>
     struct named_mark;
 
+    template<typename Char>
+    struct named_marks;
+
     template<typename BidiIter>
     struct memento;
 
@@ -26,6 +26,7 @@
 #include <boost/xpressive/detail/dynamic/matchable.hpp>
 #include <boost/xpressive/detail/dynamic/sequence.hpp>
 #include <boost/xpressive/detail/core/icase.hpp>
+#include <boost/xpressive/detail/core/nosubs.hpp>
 
 namespace boost { namespace xpressive { namespace detail
 {
@@ -17,6 +17,7 @@
 # pragma warning(disable : 4127) // conditional expression is constant
 #endif
 
+#include <vector>
 #include <boost/assert.hpp>
 #include <boost/xpressive/regex_constants.hpp>
 #include <boost/xpressive/detail/detail_fwd.hpp>
@@ -134,6 +135,30 @@ inline sequence<BidiIter> make_literal_xpression
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// make_trie_xpression
+//
+template<typename BidiIter, typename Traits>
+inline sequence<BidiIter> make_trie_xpression
+(
+    std::vector<typename Traits::string_type> const &literals
+  , regex_constants::syntax_option_type flags
+  , Traits const &tr
+)
+{
+    BOOST_ASSERT(0 != literals.size());
+    if(0 != (regex_constants::icase_ & flags))
+    {
+        trie_matcher<Traits, mpl::true_> matcher(literals, tr);
+        return make_dynamic<BidiIter>(matcher);
+    }
+    else
+    {
+        trie_matcher<Traits, mpl::false_> matcher(literals, tr);
+        return make_dynamic<BidiIter>(matcher);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // make_backref_xpression
 //
@@ -29,6 +29,36 @@
 namespace boost { namespace xpressive { namespace detail
 {
 
+    ///////////////////////////////////////////////////////////////////////////////
+    // static_compile_literal
+    //   remember the string if a static regex is nothing but a case-sensitive string
+    template<typename Xpr, typename BidiIter, typename Traits>
+    void static_compile_literal(Xpr const &, regex_impl<BidiIter> &, Traits const &)
+    {
+    }
+
+    template<typename BidiIter, typename Traits>
+    void static_compile_literal
+    (
+        static_xpression<string_matcher<Traits, mpl::false_>, end_xpression> const &xpr
+      , regex_impl<BidiIter> &impl
+      , Traits const &tr
+    )
+    {
+        optimize_literal(impl, xpr.str_, tr);
+    }
+
+    template<typename BidiIter, typename Traits>
+    void static_compile_literal
+    (
+        static_xpression<literal_matcher<Traits, mpl::false_, mpl::false_>, end_xpression> const &xpr
+      , regex_impl<BidiIter> &impl
+      , Traits const &tr
+    )
+    {
+        optimize_literal(impl, typename Traits::string_type(1, xpr.ch_), tr);
+    }
+
     ///////////////////////////////////////////////////////////////////////////////
     // static_compile_impl2
     template<typename Xpr, typename BidiIter, typename Traits>
@@ -40,17 +70,14 @@ namespace boost { namespace xpressive { namespace detail
 
         // "compile" the regex and wrap it in an xpression_adaptor.
         typedef xpression_visitor<BidiIter, mpl::false_, Traits> visitor_type;
+        typedef typename Grammar<char_type>::template impl<Xpr const &, end_xpression, visitor_type &> grammar_type;
         visitor_type visitor(tr, impl);
-        intrusive_ptr<matchable_ex<BidiIter> const> adxpr = make_adaptor<matchable_ex<BidiIter> >(
-            typename Grammar<char_type>::template impl<Xpr const &, end_xpression, visitor_type &>()(
-                xpr
-              , end_xpression()
-              , visitor
-            )
-        );
+        typename grammar_type::result_type const compiled = grammar_type()(xpr, end_xpression(), visitor);
+        intrusive_ptr<matchable_ex<BidiIter> const> adxpr = make_adaptor<matchable_ex<BidiIter> >(compiled);
 
         // Link and optimize the regex
         common_compile(adxpr, *impl, visitor.traits());
+        static_compile_literal(compiled, *impl, visitor.traits());
 
         // References changed, update dependencies.
         impl->tracking_update();
@@ -192,10 +192,10 @@ namespace boost { namespace xpressive { namespace detail
     {
         typedef regex_byref_matcher<BidiIter> type;
 
-        template<typename Matcher2>
-        static type call(Matcher2 const &m, dont_care)
+        template<typename Matcher2, typename Visitor>
+        static type call(Matcher2 const &m, Visitor &visitor)
         {
-            return type(detail::core_access<BidiIter>::get_regex_impl(m.get()));
+            return type(detail::core_access<BidiIter>::get_regex_impl(m.get()), visitor.nosubs());
         }
     };
 
@@ -204,10 +204,10 @@ namespace boost { namespace xpressive { namespace detail
     {
         typedef regex_byref_matcher<BidiIter> type;
 
-        template<typename Matcher2>
-        static type call(Matcher2 const &m, dont_care)
+        template<typename Matcher2, typename Visitor>
+        static type call(Matcher2 const &m, Visitor &visitor)
         {
-            return type(detail::core_access<BidiIter>::get_regex_impl(m.get()));
+            return type(detail::core_access<BidiIter>::get_regex_impl(m.get()), visitor.nosubs());
         }
     };
 
@@ -216,10 +216,10 @@ namespace boost { namespace xpressive { namespace detail
     {
         typedef regex_matcher<BidiIter> type;
 
-        template<typename Matcher2>
-        static type call(Matcher2 const &m, dont_care)
+        template<typename Matcher2, typename Visitor>
+        static type call(Matcher2 const &m, Visitor &visitor)
         {
-            return type(m.get());
+            return type(m.get(), visitor.nosubs());
         }
     };
 
@@ -231,7 +231,7 @@ namespace boost { namespace xpressive { namespace detail
         template<typename Matcher2, typename Visitor>
         static type call(Matcher2, Visitor &visitor)
         {
-            return type(visitor.self());
+            return type(visitor.self(), visitor.nosubs());
         }
     };
 
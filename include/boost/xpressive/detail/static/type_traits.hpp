@@ -14,9 +14,11 @@
 #endif
 
 #include <string>
+#include <iterator>
 #include <boost/config.hpp>
 #include <boost/mpl/bool.hpp>
 #include <boost/iterator/iterator_traits.hpp>
+#include <boost/type_traits/is_pointer.hpp>
 #include <boost/type_traits/is_convertible.hpp>
 #include <boost/xpressive/detail/detail_fwd.hpp>
 
@@ -57,6 +59,46 @@ struct is_random
 {
 };
 
+//////////////////////////////////////////////////////////////////////////
+// is_contiguous
+//   true if the elements in [begin, end) are known to be stored contiguously,
+//   so that &*begin can be used as a pointer to all of them.
+template<typename BidiIter>
+struct is_contiguous
+#if defined(__cpp_lib_concepts)
+  : mpl::bool_<std::contiguous_iterator<BidiIter> >
+#else
+  : is_pointer<BidiIter>
+#endif
+{
+};
+
+template<>
+struct is_contiguous<std::string::iterator>
+  : mpl::true_
+{
+};
+
+template<>
+struct is_contiguous<std::string::const_iterator>
+  : mpl::true_
+{
+};
+
+#ifndef BOOST_NO_STD_WSTRING
+template<>
+struct is_contiguous<std::wstring::iterator>
+  : mpl::true_
+{
+};
+
+template<>
+struct is_contiguous<std::wstring::const_iterator>
+  : mpl::true_
+{
+};
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 // is_string_iterator
 //
@@ -13,6 +13,7 @@
 # pragma once
 #endif
 
+#include <algorithm>
 #include <boost/ref.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/xpressive/detail/detail_fwd.hpp>
@@ -29,12 +30,25 @@ namespace boost { namespace xpressive { namespace detail
     {
         explicit xpression_visitor_base(shared_ptr<regex_impl<BidiIter> > const &self)
           : self_(self)
+          , nosubs_(false)
         {
         }
 
         void swap(xpression_visitor_base<BidiIter> &that)
         {
             this->self_.swap(that.self_);
+            std::swap(this->nosubs_, that.nosubs_);
+        }
+
+        // whether the nested regexes visited should create nested results
+        bool nosubs() const
+        {
+            return this->nosubs_;
+        }
+
+        void nosubs(bool nosubs)
+        {
+            this->nosubs_ = nosubs;
         }
 
         int get_hidden_mark()
@@ -95,6 +109,7 @@ namespace boost { namespace xpressive { namespace detail
 
     private:
         shared_ptr<regex_impl<BidiIter> > self_;
+        bool nosubs_;
     };
 
     ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,195 @@
+///////////////////////////////////////////////////////////////////////////////
+// byte_allocator.hpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_XPRESSIVE_DETAIL_UTILITY_BYTE_ALLOCATOR_HPP_EAN_10_04_2005
+#define BOOST_XPRESSIVE_DETAIL_UTILITY_BYTE_ALLOCATOR_HPP_EAN_10_04_2005
+
+// MS compatible compilers support #pragma once
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+#include <new>
+#include <cstddef>
+#include <boost/assert.hpp>
+#include <boost/detail/atomic_count.hpp>
+#include <boost/intrusive/pointer_traits.hpp>
+#include <boost/container/allocator_traits.hpp>
+
+namespace boost { namespace xpressive { namespace detail
+{
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // max_align_unit
+    //   the unit of allocation; suitably aligned for anything match_results stores
+    union max_align_unit
+    {
+        long double ld_;
+        double d_;
+        long l_;
+        void *p_;
+        void (*f_)();
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // byte_allocator
+    //   type-erased, reference-counted handle to a user-supplied allocator. A null
+    //   byte_allocator pointer means "use the global operator new".
+    struct byte_allocator
+    {
+        virtual void *allocate(std::size_t size) = 0;
+        virtual void deallocate(void *p, std::size_t size) = 0;
+
+        friend void intrusive_ptr_add_ref(byte_allocator *that)
+        {
+            ++that->count_;
+        }
+
+        friend void intrusive_ptr_release(byte_allocator *that)
+        {
+            BOOST_ASSERT(0 < that->count_);
+            if(0 == --that->count_)
+            {
+                that->destroy_();
+            }
+        }
+
+    protected:
+        byte_allocator()
+          : count_(0)
+        {
+        }
+
+        virtual ~byte_allocator()
+        {
+        }
+
+    private:
+        // the allocator object itself lives in memory it obtained from the
+        // allocator it wraps, so it must arrange its own destruction.
+        virtual void destroy_() = 0;
+
+        byte_allocator(byte_allocator const &);
+        byte_allocator &operator =(byte_allocator const &);
+
+        boost::detail::atomic_count count_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // byte_allocator_impl
+    //
+    template<typename Alloc>
+    struct byte_allocator_impl
+      : byte_allocator
+    {
+        typedef typename container::allocator_traits<Alloc>::template
+            portable_rebind_alloc<max_align_unit>::type unit_allocator;
+        typedef container::allocator_traits<unit_allocator> traits_type;
+        typedef typename traits_type::pointer pointer;
+
+        static byte_allocator *make(Alloc const &alloc)
+        {
+            unit_allocator units(alloc);
+            pointer p = traits_type::allocate(units, units_(sizeof(byte_allocator_impl)));
+            return ::new((void *)&*p) byte_allocator_impl(units);
+        }
+
+        void *allocate(std::size_t size)
+        {
+            return &*traits_type::allocate(this->alloc_, units_(size));
+        }
+
+        void deallocate(void *p, std::size_t size)
+        {
+            traits_type::deallocate(this->alloc_, pointer_(p), units_(size));
+        }
+
+    private:
+        explicit byte_allocator_impl(unit_allocator const &alloc)
+          : alloc_(alloc)
+        {
+        }
+
+        void destroy_()
+        {
+            unit_allocator units(this->alloc_);
+            this->~byte_allocator_impl();
+            traits_type::deallocate(units, pointer_(this), units_(sizeof(byte_allocator_impl)));
+        }
+
+        static std::size_t units_(std::size_t size)
+        {
+            return (size + sizeof(max_align_unit) - 1) / sizeof(max_align_unit);
+        }
+
+        static pointer pointer_(void *p)
+        {
+            return intrusive::pointer_traits<pointer>::pointer_to(*static_cast<max_align_unit *>(p));
+        }
+
+        unit_allocator alloc_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // allocate_bytes
+    //
+    inline void *allocate_bytes(byte_allocator *alloc, std::size_t size)
+    {
+        return alloc ? alloc->allocate(size) : ::operator new(size);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // deallocate_bytes
+    //
+    inline void deallocate_bytes(byte_allocator *alloc, void *p, std::size_t size)
+    {
+        if(alloc)
+            alloc->deallocate(p, size);
+        else
+            ::operator delete(p);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // allocate_bytes_guard
+    //   frees the memory if the constructor of the object placed in it throws
+    struct allocate_bytes_guard
+    {
+        byte_allocator *alloc;
+        void *p;
+        std::size_t size;
+        ~allocate_bytes_guard()
+        {
+            if(this->p)
+                deallocate_bytes(this->alloc, this->p, this->size);
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // new_with
+    //
+    template<typename T, typename Arg>
+    inline T *new_with(byte_allocator *alloc, Arg const &arg)
+    {
+        allocate_bytes_guard guard = {alloc, allocate_bytes(alloc, sizeof(T)), sizeof(T)};
+        T *that = ::new(guard.p) T(arg);
+        guard.p = 0;
+        return that;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // delete_with
+    //
+    template<typename T>
+    inline void delete_with(byte_allocator *alloc, T *that)
+    {
+        that->~T();
+        deallocate_bytes(alloc, that, sizeof(T));
+    }
+
+}}} // namespace boost::xpressive::detail
+
+#endif
@@ -123,6 +123,16 @@ struct hash_peek_bitset
         return this->icase_;
     }
 
+    // the hash of the only character in the set; count() must be 1
+    std::size_t only_hash() const
+    {
+        BOOST_ASSERT(1 == this->bset_.count());
+        std::size_t i = 0;
+        for(; !this->bset_.test(i); ++i)
+            ;
+        return i;
+    }
+
     template<typename Traits>
     bool test(char_type ch, Traits const &tr) const
     {
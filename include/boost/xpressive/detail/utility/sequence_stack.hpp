@@ -18,6 +18,7 @@
 #include <cstddef>
 #include <algorithm>
 #include <functional>
+#include <boost/xpressive/detail/utility/byte_allocator.hpp>
 
 namespace boost { namespace xpressive { namespace detail
 {
@@ -42,13 +43,13 @@ struct sequence_stack
         ~allocate_guard_t()
         {
             if(!this->dismissed)
-                sequence_stack::deallocate(this->p, this->i);
+                sequence_stack::destroy(this->p, this->i);
         }
     };
 private:
-    static T *allocate(std::size_t size, T const &t)
+    static T *construct(T *p, std::size_t size, T const &t)
     {
-        allocate_guard_t guard = {0, (T *)::operator new(size * sizeof(T)), false};
+        allocate_guard_t guard = {0, p, false};
 
         for(; guard.i < size; ++guard.i)
             ::new((void *)(guard.p + guard.i)) T(t);
@@ -57,17 +58,18 @@ private:
         return guard.p;
     }
 
-    static void deallocate(T *p, std::size_t i)
+    static void destroy(T *p, std::size_t i)
     {
         while(i-- > 0)
             (p+i)->~T();
-        ::operator delete(p);
     }
 
+    // The elements of a chunk live in the same block of memory as the
+    // chunk itself, right after it.
     struct chunk
     {
         chunk(std::size_t size, T const &t, std::size_t count, chunk *back, chunk *next)
-          : begin_(allocate(size, t))
+          : begin_(construct(elements_(this), size, t))
           , curr_(begin_ + count)
           , end_(begin_ + size)
           , back_(back)
@@ -81,7 +83,7 @@ private:
 
         ~chunk()
         {
-            deallocate(this->begin_, this->size());
+            destroy(this->begin_, this->size());
         }
 
         std::size_t size() const
@@ -89,6 +91,21 @@ private:
             return static_cast<std::size_t>(this->end_ - this->begin_);
         }
 
+        static std::size_t header_units()
+        {
+            return (sizeof(chunk) + sizeof(max_align_unit) - 1) / sizeof(max_align_unit);
+        }
+
+        static std::size_t bytes(std::size_t size)
+        {
+            return header_units() * sizeof(max_align_unit) + size * sizeof(T);
+        }
+
+        static T *elements_(chunk *that)
+        {
+            return reinterpret_cast<T *>(reinterpret_cast<max_align_unit *>(that) + header_units());
+        }
+
         T *const begin_, *curr_, *const end_;
         chunk *back_, *next_;
 
@@ -96,6 +113,53 @@ private:
         chunk &operator =(chunk const &);
     };
 
+public:
+    ///////////////////////////////////////////////////////////////////////////////
+    // seed_buffer
+    //   suitably sized and aligned storage for a first chunk of N elements
+    template<std::size_t N>
+    struct seed_buffer
+    {
+        max_align_unit units_
+        [
+            (sizeof(chunk) + sizeof(max_align_unit) - 1) / sizeof(max_align_unit)
+          + (N * sizeof(T) + sizeof(max_align_unit) - 1) / sizeof(max_align_unit)
+        ];
+    };
+
+private:
+    chunk *new_chunk_(std::size_t size, T const &t, std::size_t count, chunk *back, chunk *next)
+    {
+        std::size_t bytes = chunk::bytes(size);
+        allocate_bytes_guard guard = {this->alloc_, allocate_bytes(this->alloc_, bytes), bytes};
+        chunk *that = ::new(guard.p) chunk(size, t, count, back, next);
+        guard.p = 0;
+        this->bytes_ += bytes;
+        return that;
+    }
+
+    void delete_chunk_(chunk *c)
+    {
+        std::size_t bytes = chunk::bytes(c->size());
+        c->~chunk();
+        if(static_cast<void *>(c) != this->seed_)
+        {
+            deallocate_bytes(this->alloc_, c, bytes);
+            this->bytes_ -= bytes;
+        }
+    }
+
+    // how many elements fit in the seed buffer
+    std::size_t seed_size_() const
+    {
+        std::size_t header = chunk::bytes(0);
+        return this->seed_bytes_ > header ? (this->seed_bytes_ - header) / sizeof(T) : 0;
+    }
+
+    byte_allocator *alloc_;
+    void *seed_;
+    std::size_t seed_bytes_;
+    std::size_t bytes_; // allocated, not counting the seed
     chunk *current_chunk_;
 
     // Cache these for faster access
@@ -122,14 +186,22 @@ private:
                 return this->begin_;
             }
 
-            // grow exponentially
+            // grow exponentially, but never by less than a full first chunk
             std::size_t new_size = (std::max)(
                 count
-              , static_cast<std::size_t>(static_cast<double>(this->current_chunk_->size()) * 1.5)
+              , (std::max)(
+                    static_cast<std::size_t>(256U)
+                  , static_cast<std::size_t>(static_cast<double>(this->current_chunk_->size()) * 1.5)
+                )
             );
 
             // Create a new expr and insert it into the list
-            this->current_chunk_ = new chunk(new_size, t, count, this->current_chunk_, this->current_chunk_->next_);
+            this->current_chunk_ = this->new_chunk_(new_size, t, count, this->current_chunk_, this->current_chunk_->next_);
+        }
+        else if(count <= this->seed_size_())
+        {
+            // the first chunk goes in the seed buffer if it fits
+            this->current_chunk_ = ::new(this->seed_) chunk(this->seed_size_(), t, count, 0, 0);
         }
         else
         {
@@ -137,7 +209,7 @@ private:
             std::size_t new_size = (std::max)(count, static_cast<std::size_t>(256U));
 
             // Create a new expr and insert it into the list
-            this->current_chunk_ = new chunk(new_size, t, count, 0, 0);
+            this->current_chunk_ = this->new_chunk_(new_size, t, count, 0, 0);
         }
 
         this->begin_ = this->current_chunk_->begin_;
@@ -165,8 +237,13 @@ private:
     }
 
 public:
-    sequence_stack()
-      : current_chunk_(0)
+    // seed, if given, is storage for the first chunk, such as a seed_buffer
+    explicit sequence_stack(byte_allocator *alloc = 0, void *seed = 0, std::size_t seed_bytes = 0)
+      : alloc_(alloc)
+      , seed_(seed)
+      , seed_bytes_(seed_bytes)
+      , bytes_(0)
+      , current_chunk_(0)
       , begin_(0)
       , curr_(0)
       , end_(0)
@@ -203,7 +280,7 @@ public:
         for(chunk *next; this->current_chunk_; this->current_chunk_ = next)
         {
             next = this->current_chunk_->next_;
-            delete this->current_chunk_;
+            this->delete_chunk_(this->current_chunk_);
         }
 
         this->begin_ = this->curr_ = this->end_ = 0;
@@ -245,6 +322,31 @@ public:
         this->current_chunk_->curr_ = this->curr_ = ptr;
     }
 
+    // the number of bytes allocated for chunks, not counting the seed buffer
+    std::size_t retained_bytes() const
+    {
+        return this->bytes_;
+    }
+
+    // remove unused nodes from the end of the chain until no more than
+    // max_bytes remain allocated
+    void trim(std::size_t max_bytes)
+    {
+        if(this->current_chunk_ && this->bytes_ > max_bytes)
+        {
+            chunk *last = this->current_chunk_;
+            while(last->next_)
+                last = last->next_;
+
+            for(chunk *back; last != this->current_chunk_ && this->bytes_ > max_bytes; last = back)
+            {
+                back = last->back_;
+                back->next_ = 0;
+                this->delete_chunk_(last);
+            }
+        }
+    }
+
     // shrink-to-fit: remove any unused nodes in the chain
     void conserve()
     {
@@ -253,7 +355,7 @@ public:
             for(chunk *next; this->current_chunk_->next_; this->current_chunk_->next_ = next)
             {
                 next = this->current_chunk_->next_->next_;
-                delete this->current_chunk_->next_;
+                this->delete_chunk_(this->current_chunk_->next_);
             }
         }
     }
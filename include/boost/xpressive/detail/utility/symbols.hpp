@@ -21,12 +21,32 @@
 # pragma once
 #endif
 
-#include <boost/noncopyable.hpp>
+#include <vector>
+#include <utility>
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/integer_traits.hpp>
 #include <boost/range/begin.hpp>
 #include <boost/range/end.hpp>
 #include <boost/range/value_type.hpp>
 #include <boost/range/const_iterator.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/xpressive/regex_error.hpp>
+#include <boost/xpressive/detail/utility/ignore_unused.hpp>
+
+// Adapting to the lookups in multithreaded programs is opt-in, and needs
+// thread_local, <atomic> and <mutex>. With BOOST_DISABLE_THREADS, the TST
+// adapts by itself.
+#if defined(BOOST_XPRESSIVE_USE_ADAPTIVE_SYMBOLS) && !defined(BOOST_DISABLE_THREADS) \
+ && !defined(BOOST_NO_CXX11_THREAD_LOCAL) && !defined(BOOST_NO_CXX11_HDR_ATOMIC) && !defined(BOOST_NO_CXX11_HDR_MUTEX)
+# define BOOST_XPRESSIVE_HAS_ADAPTIVE_SYMBOLS
+#endif
+
+#ifdef BOOST_XPRESSIVE_HAS_ADAPTIVE_SYMBOLS
+# include <atomic>
+# include <mutex>
+#endif
 
 namespace boost { namespace xpressive { namespace detail
 {
@@ -49,234 +69,592 @@ namespace boost { namespace xpressive { namespace detail
         template<typename Trans>
         void load(Map const &map, Trans trans)
         {
+            builder b;
             iterator begin = boost::begin(map);
             iterator end = boost::end(map);
-            node* root_p = this->root.get();
             for(; begin != end; ++begin)
             {
-                key_iterator kbegin = boost::begin(begin->first);
-                key_iterator kend = boost::end(begin->first);
-                root_p = this->insert(root_p, kbegin, kend, &begin->second, trans);
+                b.insert(boost::begin(begin->first), boost::end(begin->first), &begin->second, trans);
             }
-            this->root.reset(root_p);
+            this->root.reset(new trie(b.nodes, b.root_, b.results, b.empty));
+            #ifdef BOOST_XPRESSIVE_HAS_ADAPTIVE_SYMBOLS
+            this->adapt.reset(new adaptor(this->root));
+            #endif
         }
 
         template<typename BidiIter, typename Trans>
         result_type operator ()(BidiIter &begin, BidiIter end, Trans trans) const
         {
-            return this->search(begin, end, trans, this->root.get());
+            #ifdef BOOST_XPRESSIVE_HAS_ADAPTIVE_SYMBOLS
+            return this->adapt ? this->adapt->search(begin, end, trans) : 0;
+            #else
+            return this->root ? this->root->search(begin, end, trans) : 0;
+            #endif
+        }
+
+        // calls sink(result, end) for each key that begins at begin, from the
+        // shortest to the longest, where end is where that key ends. Unlike
+        // operator(), this doesn't adapt the TST to the lookups.
+        template<typename BidiIter, typename Trans, typename Sink>
+        void prefixes(BidiIter begin, BidiIter end, Trans trans, Sink &sink) const
+        {
+            if(this->root)
+            {
+                this->root->prefixes_(begin, end, trans, sink);
+            }
         }
 
         template<typename Sink>
         void peek(Sink const &sink) const
         {
-            this->peek_(this->root.get(), sink);
+            if(this->root)
+            {
+                if(this->root->empty_)
+                {
+                    sink(char_type());
+                }
+                this->root->peek_(this->root->root_, sink);
+            }
+        }
+
+        // calls visitor.start(), then visitor.node() for each node in the order
+        // they are stored, then visitor.result() for each result. Nodes and
+        // results are numbered from 1, and 0 means none.
+        template<typename Visitor>
+        void visit(Visitor &visitor) const
+        {
+            BOOST_ASSERT(this->root);
+            trie const &t = *this->root;
+            visitor.start(t.nodes_.size() - 1, t.results_.size() - 1, t.root_, t.empty_);
+            for(std::size_t i = 1; i < t.nodes_.size(); ++i)
+            {
+                node const &n = t.nodes_[i];
+                visitor.node(n.ch, n.lo, n.eq, n.hi, n.result);
+            }
+            for(std::size_t i = 1; i < t.results_.size(); ++i)
+            {
+                visitor.result(t.results_[i]);
+            }
         }
 
     private:
+        typedef boost::uint32_t index_type;
+
         ///////////////////////////////////////////////////////////////////////////////
-        // struct node : a node in the TST. 
-        //     The "eq" field stores the result pointer when ch is zero.
-        // 
+        // struct node : a node in the TST.
+        //     Nodes refer to each other by their index in an array, and 0 means
+        //     none. A key ends at a node if its result is not 0; the result is an
+        //     index into another array.
+        //
         struct node
-            : boost::noncopyable
         {
-            node(char_type c)
+            explicit node(char_type c = char_type())
               : ch(c)
               , lo(0)
               , eq(0)
               , hi(0)
+              , result(0)
               #ifdef BOOST_DISABLE_THREADS
               , tau(0)
               #endif
             {}
 
-            ~node()
-            {
-                delete lo;
-                if (ch)
-                    delete eq;
-                delete hi;
-            }
-
-            void swap(node& that)
-            {
-                std::swap(ch, that.ch);
-                std::swap(lo, that.lo);
-                std::swap(eq, that.eq);
-                std::swap(hi, that.hi);
-                #ifdef BOOST_DISABLE_THREADS
-                std::swap(tau, that.tau);
-                #endif
-            }
-
             char_type ch;
-            node* lo;
-            union
-            {
-                node* eq;
-                result_type result;
-            };
-            node* hi;
+            index_type lo;
+            index_type eq;
+            index_type hi;
+            index_type result;
             #ifdef BOOST_DISABLE_THREADS
             long tau;
             #endif
         };
 
         ///////////////////////////////////////////////////////////////////////////////
-        // insert : insert a string into the TST
-        // 
-        template<typename Trans>
-        node* insert(node* p, key_iterator &begin, key_iterator end, result_type r, Trans trans) const
+        // struct builder : the TST as the keys are inserted.
+        //
+        struct builder
         {
-            char_type c1 = 0;
+            builder()
+              : nodes(1)
+              , results(1, result_type(0))
+              , root_(0)
+              , empty(0)
+            {}
 
-            if(begin != end)
+            ///////////////////////////////////////////////////////////////////////////////
+            // insert : insert a string into the TST
+            //
+            template<typename Trans>
+            void insert(key_iterator begin, key_iterator end, result_type r, Trans trans)
             {
-                c1 = trans(*begin);
+                if(begin == end)
+                {
+                    this->empty = r;
+                    return;
+                }
+
+                index_type parent = 0;
+                int which = 0;
+                char_type c1 = trans(*begin);
+
+                for(;;)
+                {
+                    index_type p = this->link(parent, which);
+                    if(0 == p)
+                    {
+                        // make_node may reallocate the nodes, so link afterward
+                        p = this->make_node(c1);
+                        this->link(parent, which) = p;
+                    }
+
+                    node &n = this->nodes[p];
+                    if(c1 < n.ch)
+                    {
+                        which = -1;
+                    }
+                    else if(n.ch < c1)
+                    {
+                        which = 1;
+                    }
+                    else if(++begin != end)
+                    {
+                        which = 0;
+                        c1 = trans(*begin);
+                    }
+                    else
+                    {
+                        if(0 == n.result)
+                        {
+                            n.result = static_cast<index_type>(this->results.size());
+                            this->results.push_back(r);
+                        }
+                        this->results[n.result] = r;
+                        return;
+                    }
+                    parent = p;
+                }
             }
 
-            if(!p)
+            index_type &link(index_type p, int which)
             {
-                p = new node(c1);
+                return 0 == p ? this->root_ : which < 0 ? this->nodes[p].lo : which > 0 ? this->nodes[p].hi : this->nodes[p].eq;
             }
 
-            if(c1 < p->ch)
+            index_type make_node(char_type c)
             {
-                p->lo = this->insert(p->lo, begin, end, r, trans);
+                BOOST_XPR_ENSURE_
+                (
+                    this->nodes.size() < integer_traits<index_type>::const_max
+                  , regex_constants::error_space
+                  , "symbol table too large"
+                );
+                this->nodes.push_back(node(c));
+                return static_cast<index_type>(this->nodes.size() - 1);
             }
-            else if(c1 == p->ch)
+
+            std::vector<node> nodes;
+            std::vector<result_type> results; // results[0] is null
+            index_type root_;
+            result_type empty;
+        };
+
+        ///////////////////////////////////////////////////////////////////////////////
+        // struct trie : the TST, frozen once the keys are inserted.
+        //     The nodes are in one array, in breadth-first order, and the binary
+        //     search tree of each character position is balanced.
+        //
+        struct trie
+        {
+            trie(std::vector<node> const &nodes, index_type root, std::vector<result_type> const &results, result_type empty, std::vector<long> const *hits = 0)
+              : nodes_(1)
+              , results_(results)
+              , root_(0)
+              , empty_(empty)
             {
-                if(0 == c1)
-                {
-                    p->result = r;
-                }
-                else
-                {
-                    p->eq = this->insert(p->eq, ++begin, end, r, trans);
-                }
+                this->build_(nodes, root, hits);
             }
-            else
+
+            #ifdef BOOST_XPRESSIVE_HAS_ADAPTIVE_SYMBOLS
+            // a new TST with the same keys, with the root of each binary search
+            // tree chosen so that the keys looked up most often are found soonest
+            trie *reweighted() const
             {
-                p->hi = this->insert(p->hi, begin, end, r, trans);
+                return new trie(this->nodes_, this->root_, this->results_, this->empty_, &this->hits_);
             }
+            #endif
 
-            return p;
-        }
-
-        #ifdef BOOST_DISABLE_THREADS
-        ///////////////////////////////////////////////////////////////////////////////
-        // conditional rotation : the goal is to minimize the overall
-        //     weighted path length of each binary search tree
-        // 
-        bool cond_rotation(bool left, node* const i, node* const j) const
-        {
-            // don't rotate top node in binary search tree
-            if (i == j)
-                return false;
-            // calculate psi (the rotation condition)
-            node* const k = (left ? i->hi : i->lo);
-            long psi = 2*i->tau - j->tau - (k ? k->tau : 0);
-            if (psi <= 0)
-                return false;
-
-            // recalculate the tau values
-            j->tau += -i->tau + (k ? k->tau : 0);
-            i->tau +=  j->tau - (k ? k->tau : 0);
-            // fixup links and swap nodes
-            if (left)
+            ///////////////////////////////////////////////////////////////////////////////
+            // build_ : lay out the nodes in breadth-first order. If there are hit
+            //     counts, they weigh the choice of each root, and they carry over.
+            //
+            void build_(std::vector<node> const &nodes, index_type root, std::vector<long> const *hits)
             {
-                j->lo = k;
-                i->hi = i;
+                this->nodes_.reserve(nodes.size());
+                #ifdef BOOST_XPRESSIVE_HAS_ADAPTIVE_SYMBOLS
+                this->hits_.reserve(nodes.size());
+                this->hits_.push_back(0);
+                #endif
+
+                // the nodes of each binary search tree, in order; a task makes
+                // a tree of some of them, in breadth-first order
+                std::vector<index_type> order;
+                std::vector<task> tasks;
+                std::size_t begin = collect_(nodes, root, order);
+                tasks.push_back(task(begin, order.size(), 0, 0));
+
+                for(std::size_t t = 0; t != tasks.size(); ++t)
+                {
+                    task const tk = tasks[t];
+                    if(tk.begin == tk.end)
+                    {
+                        continue;
+                    }
+
+                    std::size_t mid = pick_(order, tk.begin, tk.end, hits);
+                    node const &old = nodes[order[mid]];
+                    index_type p = static_cast<index_type>(this->nodes_.size());
+                    this->nodes_.push_back(node(old.ch));
+                    this->nodes_[p].result = old.result;
+                    this->link_(tk.parent, tk.which) = p;
+                    #ifdef BOOST_XPRESSIVE_HAS_ADAPTIVE_SYMBOLS
+                    this->hits_.push_back(hits ? (*hits)[order[mid]] : 0);
+                    #endif
+
+                    tasks.push_back(task(tk.begin, mid, p, -1));
+                    begin = collect_(nodes, old.eq, order);
+                    tasks.push_back(task(begin, order.size(), p, 0));
+                    tasks.push_back(task(mid + 1, tk.end, p, 1));
+                }
             }
-            else
+
+            // the middle of order[begin, end), or the node that best splits
+            // the hits if there are any
+            static std::size_t pick_(std::vector<index_type> const &order, std::size_t begin, std::size_t end, std::vector<long> const *hits)
             {
-                j->hi = k;
-                i->lo = i;
+                if(0 == hits)
+                {
+                    return begin + (end - begin) / 2;
+                }
+
+                // every node weighs at least 1, so the ones never hit stay balanced
+                long total = 0, left = 0;
+                for(std::size_t i = begin; i != end; ++i)
+                {
+                    total += (*hits)[order[i]] + 1;
+                }
+                for(;; ++begin)
+                {
+                    long const w = (*hits)[order[begin]] + 1;
+                    if(begin + 1 == end || total <= 2 * left + w)
+                    {
+                        return begin;
+                    }
+                    left += w;
+                }
             }
-            (*i).swap(*j);
-            return true;
-        }
-        #endif
 
-        ///////////////////////////////////////////////////////////////////////////////
-        // search : find a string in the TST
-        // 
-        template<typename BidiIter, typename Trans>
-        result_type search(BidiIter &begin, BidiIter end, Trans trans, node* p) const
-        {
-            result_type r = 0;
-            #ifdef BOOST_DISABLE_THREADS
-            node* p2 = p;
-            bool left = false;
-            #endif
-            char_type c1 = (begin != end ? trans(*begin) : 0);
-            while(p)
+            ///////////////////////////////////////////////////////////////////////////////
+            // search : find the longest string in the TST that begins at begin
+            //
+            template<typename BidiIter, typename Trans>
+            result_type search(BidiIter &begin, BidiIter end, Trans trans, long *hits = 0)
             {
+                detail::ignore_unused(hits);
+                if(begin == end)
+                {
+                    return this->empty_;
+                }
+
+                index_type r = 0;
+                BidiIter cur = begin;
+                char_type c1 = trans(*cur);
+                index_type p = this->root_;
                 #ifdef BOOST_DISABLE_THREADS
-                ++p->tau;
+                index_type p2 = p;
+                bool left = false;
                 #endif
-                if(c1 == p->ch)
+
+                while(0 != p)
                 {
-                    // conditional rotation test
+                    node &n = this->nodes_[p];
                     #ifdef BOOST_DISABLE_THREADS
-                    if (this->cond_rotation(left, p, p2))
-                        p = p2;
+                    ++n.tau;
                     #endif
-                    if (0 == p->ch)
+                    if(c1 == n.ch)
                     {
-                        // it's a match!
-                        r = p->result;
+                        // conditional rotation test
+                        #ifdef BOOST_DISABLE_THREADS
+                        if(this->cond_rotation(left, p, p2))
+                            p = p2;
+                        #endif
+                        #ifdef BOOST_XPRESSIVE_HAS_ADAPTIVE_SYMBOLS
+                        if(0 != hits)
+                            ++hits[p];
+                        #endif
+                        node const &m = this->nodes_[p];
+                        if(0 != m.result)
+                        {
+                            // it's a match! keep looking for a longer one
+                            r = m.result;
+                            begin = cur;
+                            ++begin;
+                        }
+                        if(++cur == end)
+                            break;
+                        c1 = trans(*cur);
+                        p = m.eq;
+                        #ifdef BOOST_DISABLE_THREADS
+                        p2 = p;
+                        left = false;
+                        #endif
                     }
-                    if(begin == end)
-                        break;
-                    ++begin;
-                    p = p->eq;
-                    // search for the longest match first
-                    r = search(begin,end,trans,p);
-                    if (0 == r)
+                    else if(c1 < n.ch)
+                    {
+                        #ifdef BOOST_DISABLE_THREADS
+                        left = true;
+                        p2 = p;
+                        #endif
+                        p = n.lo;
+                    }
+                    else // (c1 > n.ch)
+                    {
+                        #ifdef BOOST_DISABLE_THREADS
+                        left = false;
+                        p2 = p;
+                        #endif
+                        p = n.hi;
+                    }
+                }
+                return this->results_[r];
+            }
+
+            ///////////////////////////////////////////////////////////////////////////////
+            // prefixes_ : report every string in the TST that begins at cur
+            //
+            template<typename BidiIter, typename Trans, typename Sink>
+            void prefixes_(BidiIter cur, BidiIter end, Trans trans, Sink &sink) const
+            {
+                if(this->empty_)
+                {
+                    sink(this->empty_, cur);
+                }
+
+                if(cur == end)
+                {
+                    return;
+                }
+
+                char_type c1 = trans(*cur);
+                index_type p = this->root_;
+                while(0 != p)
+                {
+                    node const &n = this->nodes_[p];
+                    if(c1 == n.ch)
                     {
-                        // search for a match ending here
-                        r = search(end,end,trans,p);
-                        if (0 == r)
+                        ++cur;
+                        if(0 != n.result)
                         {
-                            --begin;
+                            sink(this->results_[n.result], cur);
                         }
+                        if(cur == end)
+                            break;
+                        c1 = trans(*cur);
+                        p = n.eq;
+                    }
+                    else
+                    {
+                        p = (c1 < n.ch) ? n.lo : n.hi;
                     }
-                    break;
                 }
-                else if(c1 < p->ch)
+            }
+
+            #ifdef BOOST_DISABLE_THREADS
+            ///////////////////////////////////////////////////////////////////////////////
+            // conditional rotation : the goal is to minimize the overall
+            //     weighted path length of each binary search tree
+            //
+            bool cond_rotation(bool left, index_type const i, index_type const j)
+            {
+                // don't rotate top node in binary search tree
+                if (i == j)
+                    return false;
+                // calculate psi (the rotation condition)
+                node &ni = this->nodes_[i], &nj = this->nodes_[j];
+                index_type const k = (left ? ni.hi : ni.lo);
+                long const tau_k = (k ? this->nodes_[k].tau : 0);
+                long psi = 2*ni.tau - nj.tau - tau_k;
+                if (psi <= 0)
+                    return false;
+
+                // recalculate the tau values
+                nj.tau += -ni.tau + tau_k;
+                ni.tau +=  nj.tau - tau_k;
+                // fixup links and swap nodes
+                if (left)
                 {
-                    #ifdef BOOST_DISABLE_THREADS
-                    left = true;
-                    p2 = p;
-                    #endif
-                    p = p->lo;
+                    nj.lo = k;
+                    ni.hi = i;
                 }
-                else // (c1 > p->ch)
+                else
                 {
-                    #ifdef BOOST_DISABLE_THREADS
-                    left = false;
-                    p2 = p;
-                    #endif
-                    p = p->hi;
+                    nj.hi = k;
+                    ni.lo = i;
                 }
+                std::swap(ni, nj);
+                return true;
             }
-            return r;
-        }
+            #endif
 
-        template<typename Sink>
-        void peek_(node const *const &p, Sink const &sink) const
+            template<typename Sink>
+            void peek_(index_type p, Sink const &sink) const
+            {
+                if(p)
+                {
+                    node const &n = this->nodes_[p];
+                    sink(n.ch);
+                    this->peek_(n.lo, sink);
+                    this->peek_(n.hi, sink);
+                }
+            }
+
+            struct task
+            {
+                task(std::size_t b, std::size_t e, index_type p, int w)
+                  : begin(b)
+                  , end(e)
+                  , parent(p)
+                  , which(w)
+                {}
+
+                std::size_t begin;
+                std::size_t end;
+                index_type parent;
+                int which;
+            };
+
+            // appends the nodes of the binary search tree at p to order, in
+            // order, and returns where they begin
+            static std::size_t collect_(std::vector<node> const &nodes, index_type p, std::vector<index_type> &order)
+            {
+                std::size_t const begin = order.size();
+                std::vector<index_type> stack;
+                while(0 != p || !stack.empty())
+                {
+                    for(; 0 != p; p = nodes[p].lo)
+                    {
+                        stack.push_back(p);
+                    }
+                    p = stack.back();
+                    stack.pop_back();
+                    order.push_back(p);
+                    p = nodes[p].hi;
+                }
+                return begin;
+            }
+
+            index_type &link_(index_type p, int which)
+            {
+                return 0 == p ? this->root_ : which < 0 ? this->nodes_[p].lo : which > 0 ? this->nodes_[p].hi : this->nodes_[p].eq;
+            }
+
+            std::vector<node> nodes_;
+            std::vector<result_type> results_; // results_[0] is null
+            index_type root_;
+            result_type empty_;
+            #ifdef BOOST_XPRESSIVE_HAS_ADAPTIVE_SYMBOLS
+            std::vector<long> hits_; // how often each node matched, in sampled searches
+            #endif
+        };
+
+        #ifdef BOOST_XPRESSIVE_HAS_ADAPTIVE_SYMBOLS
+        ///////////////////////////////////////////////////////////////////////////////
+        // struct adaptor : shares a TST among threads, and now and then swaps it
+        //     for one built for the keys that are looked up most. Each thread
+        //     samples about one search in sample_rate; a sampled search counts its
+        //     hits, unless another thread is busy counting. The TSTs are never
+        //     changed once they're searched, and the old ones stay alive,
+        //     because another thread may still be searching them.
+        //
+        struct adaptor
         {
-            if(p)
+            BOOST_STATIC_CONSTANT(unsigned, sample_rate = 16);
+            BOOST_STATIC_CONSTANT(long, first_rebuild = 1024);
+            BOOST_STATIC_CONSTANT(std::size_t, max_rebuilds = 4);
+
+            explicit adaptor(boost::shared_ptr<trie> const &t)
+              : current_(t.get())
+              , done_(false)
+              , mutex_()
+              , tries_(1, t)
+              , samples_(0)
+              , next_rebuild_(first_rebuild)
             {
-                sink(p->ch);
-                this->peek_(p->lo, sink);
-                this->peek_(p->hi, sink);
             }
-        }
 
-        boost::shared_ptr<node> root;
+            template<typename BidiIter, typename Trans>
+            result_type search(BidiIter &begin, BidiIter end, Trans trans)
+            {
+                // pick the samples at random, so a workload that repeats doesn't
+                // show the same lookup every time. Each thread starts from where
+                // its own seed lives, so threads don't sample in step.
+                static thread_local boost::uint32_t seed = thread_seed_(&seed);
+                seed = seed * 1664525u + 1013904223u;
+                if(0 != (seed >> 16) % sample_rate || this->done_.load(std::memory_order_relaxed))
+                {
+                    return this->current_.load(std::memory_order_acquire)->search(begin, end, trans);
+                }
+
+                std::unique_lock<std::mutex> lock(this->mutex_, std::try_to_lock);
+                trie *t = this->current_.load(std::memory_order_acquire);
+                if(!lock.owns_lock())
+                {
+                    return t->search(begin, end, trans);
+                }
+
+                result_type result = t->search(begin, end, trans, &t->hits_[0]);
+                if(++this->samples_ == this->next_rebuild_)
+                {
+                    this->rebuild_(*t);
+                }
+                return result;
+            }
+
+        private:
+            static boost::uint32_t thread_seed_(void const *p)
+            {
+                boost::uintmax_t const a = reinterpret_cast<std::size_t>(p);
+                return static_cast<boost::uint32_t>(a ^ (a >> 16) ^ (a >> 32));
+            }
+
+            void rebuild_(trie &t)
+            {
+                boost::shared_ptr<trie> next(t.reweighted());
+                this->tries_.push_back(next);
+                std::vector<long>().swap(t.hits_);
+                this->current_.store(next.get(), std::memory_order_release);
+
+                this->next_rebuild_ *= 4;
+                if(max_rebuilds < this->tries_.size())
+                {
+                    this->done_.store(true, std::memory_order_relaxed);
+                }
+            }
+
+            std::atomic<trie *> current_;
+            std::atomic<bool> done_;
+            std::mutex mutex_;
+
+            // guarded by mutex_
+            std::vector<boost::shared_ptr<trie> > tries_;
+            long samples_;
+            long next_rebuild_;
+        };
+        #endif
+
+        boost::shared_ptr<trie> root;
+        #ifdef BOOST_XPRESSIVE_HAS_ADAPTIVE_SYMBOLS
+        boost::shared_ptr<adaptor> adapt;
+        #endif
     };
 
 }}} // namespace boost::xpressive::detail
@@ -0,0 +1,93 @@
+///////////////////////////////////////////////////////////////////////////////
+// thread_local_pool.hpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_XPRESSIVE_DETAIL_UTILITY_THREAD_LOCAL_POOL_HPP_EAN_10_04_2005
+#define BOOST_XPRESSIVE_DETAIL_UTILITY_THREAD_LOCAL_POOL_HPP_EAN_10_04_2005
+
+// MS compatible compilers support #pragma once
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+#include <cstddef>
+#include <boost/config.hpp>
+#include <boost/xpressive/detail/utility/byte_allocator.hpp>
+
+// The pool is opt-in, and needs thread_local.
+#if defined(BOOST_XPRESSIVE_USE_THREAD_LOCAL_POOL) && !defined(BOOST_NO_CXX11_THREAD_LOCAL)
+# define BOOST_XPRESSIVE_HAS_THREAD_LOCAL_POOL
+#endif
+
+#ifdef BOOST_XPRESSIVE_HAS_THREAD_LOCAL_POOL
+
+namespace boost { namespace xpressive { namespace detail
+{
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // thread_local_pool
+    //   keeps up to Size objects of type T per thread for reuse. The objects must
+    //   have been allocated with new_with() from the global heap.
+    template<typename T, std::size_t Size>
+    struct thread_local_pool
+    {
+        // returns a pooled object, or null if there are none
+        static T *acquire()
+        {
+            holder &h = holder_;
+            return (0 != h.size_) ? h.objs_[--h.size_] : 0;
+        }
+
+        // keeps that for later, or returns false if the pool is full or
+        // has already been destroyed along with its thread
+        static bool release(T *that)
+        {
+            if(dead_)
+            {
+                return false;
+            }
+
+            holder &h = holder_;
+            if(Size == h.size_)
+            {
+                return false;
+            }
+
+            h.objs_[h.size_++] = that;
+            return true;
+        }
+
+    private:
+        struct holder
+        {
+            ~holder()
+            {
+                dead_ = true;
+                while(0 != this->size_)
+                {
+                    delete_with(0, this->objs_[--this->size_]);
+                }
+            }
+
+            T *objs_[Size];
+            std::size_t size_;
+        };
+
+        static thread_local holder holder_;
+        static thread_local bool dead_;
+    };
+
+    template<typename T, std::size_t Size>
+    thread_local typename thread_local_pool<T, Size>::holder thread_local_pool<T, Size>::holder_;
+
+    template<typename T, std::size_t Size>
+    thread_local bool thread_local_pool<T, Size>::dead_ = false;
+
+}}} // namespace boost::xpressive::detail
+
+#endif
+
+#endif
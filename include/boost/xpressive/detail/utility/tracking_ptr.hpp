@@ -375,7 +375,7 @@ inline void enable_reference_tracking<Derived>::dump_(std::ostream &sout) const
 ///////////////////////////////////////////////////////////////////////////////
 // tracking_ptr
 //   holder for a reference-tracked type. Does cycle-breaking, lazy initialization
-//   and copy-on-write. TODO: implement move semantics.
+//   and copy-on-write.
 //
 template<typename Type>
 struct tracking_ptr
@@ -420,6 +420,33 @@ struct tracking_ptr
         return *this;
     }
 
+    #ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+    // Steals that's implementation. Anything that references that now
+    // references *this instead.
+    tracking_ptr(tracking_ptr<element_type> &&that) BOOST_NOEXCEPT
+      : impl_()
+    {
+        this->impl_.swap(that.impl_);
+    }
+
+    // Only throws if something references *this, in which case the
+    // implementation can't be replaced and must be copied into.
+    tracking_ptr<element_type> &operator =(tracking_ptr<element_type> &&that)
+    {
+        if(this->has_deps_())
+        {
+            this->operator =(static_cast<tracking_ptr<element_type> const &>(that));
+        }
+        else if(this != &that)
+        {
+            intrusive_ptr<element_type> impl;
+            impl.swap(that.impl_);
+            this->impl_.swap(impl);
+        }
+        return *this;
+    }
+    #endif
+
     // NOTE: this does *not* do tracking. Can't provide a non-throwing swap that tracks references
     void swap(tracking_ptr<element_type> &that) // throw()
     {
@@ -0,0 +1,214 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file dictionary.hpp
+/// Contains the definition of the dictionary\<\> class template, which
+/// replaces the keys of a map with their values in a single pass.
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_XPRESSIVE_DICTIONARY_HPP_EAN_10_04_2005
+#define BOOST_XPRESSIVE_DICTIONARY_HPP_EAN_10_04_2005
+
+// MS compatible compilers support #pragma once
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+#include <string>
+#include <iterator>
+#include <algorithm>
+#include <boost/shared_ptr.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/begin.hpp>
+#include <boost/range/value_type.hpp>
+#include <boost/xpressive/regex_traits.hpp>
+#include <boost/xpressive/regex_constants.hpp>
+#include <boost/xpressive/detail/core/matcher/attr_matcher.hpp>
+#include <boost/xpressive/detail/utility/symbols.hpp>
+
+namespace boost { namespace xpressive
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// dictionary
+//
+/// \brief Class template dictionary\<\> replaces the keys of a map with their
+/// values, wherever they occur in a sequence.
+///
+/// The keys are loaded into the same ternary search trie that a static regex
+/// like <tt>(a1 = map)</tt> uses. replace() makes one pass over the input from
+/// left to right. At each position it looks up the longest key that starts
+/// there; if there is one, it writes the key's value in its place and goes on
+/// after the key, and otherwise it copies the character. The map's values must
+/// be strings. An empty key never matches.
+///
+/// The dictionary keeps a copy of the map. Copies of a dictionary share it.
+template<typename Map>
+struct dictionary
+{
+    typedef Map map_type;
+    typedef typename range_value<Map>::type::first_type key_type;
+    typedef typename range_value<Map>::type::second_type mapped_type;
+    typedef typename range_value<key_type>::type char_type;
+    typedef std::basic_string<char_type> string_type;
+    typedef regex_traits<char_type> traits_type;
+    typedef regex_constants::match_flag_type flag_type;
+
+    /// \param map   The keys to find and the values to replace them with.
+    /// \param flags If flags \& icase, keys are found regardless of case.
+    explicit dictionary(Map const &map, regex_constants::syntax_option_type flags = regex_constants::ECMAScript)
+      : impl_(new impl(map, 0 != (flags & regex_constants::icase_)))
+    {
+    }
+
+    /// Writes [begin, end) to out, with each key replaced by its value.
+    ///
+    /// \param out   The output iterator to write to.
+    /// \param begin The beginning of the input sequence.
+    /// \param end   The end of the input sequence.
+    /// \param flags If flags \& format_no_copy, only the values are written.
+    ///              If flags \& format_first_only, only the first key found is
+    ///              replaced.
+    /// \return      The output iterator after the last character written.
+    template<typename OutIter, typename BidiIter>
+    OutIter replace(OutIter out, BidiIter begin, BidiIter end, flag_type flags = regex_constants::format_default) const
+    {
+        impl const &that = *this->impl_;
+        if(that.icase_)
+        {
+            detail::char_translate<traits_type, true> trans(that.traits_);
+            return this->replace_(out, begin, end, flags, trans);
+        }
+        else
+        {
+            detail::char_translate<traits_type, false> trans(that.traits_);
+            return this->replace_(out, begin, end, flags, trans);
+        }
+    }
+
+    /// \overload
+    ///
+    string_type replace(string_type const &str, flag_type flags = regex_constants::format_default) const
+    {
+        string_type result;
+        this->replace(std::back_inserter(result), str.begin(), str.end(), flags);
+        return result;
+    }
+
+    /// \overload
+    ///
+    string_type replace(char_type const *str, flag_type flags = regex_constants::format_default) const
+    {
+        char_type const *end = str + std::char_traits<char_type>::length(str);
+        string_type result;
+        this->replace(std::back_inserter(result), str, end, flags);
+        return result;
+    }
+
+private:
+    /// INTERNAL ONLY
+    ///
+    struct impl
+    {
+        impl(Map const &map, bool icase)
+          : map_(map)
+          , sym_()
+          , traits_()
+          , icase_(icase)
+        {
+            std::fill(this->first_, this->first_ + 256, false);
+            if(this->icase_)
+            {
+                this->load_(detail::char_translate<traits_type, true>(this->traits_));
+            }
+            else
+            {
+                this->load_(detail::char_translate<traits_type, false>(this->traits_));
+            }
+        }
+
+        template<typename Trans>
+        void load_(Trans const &trans)
+        {
+            this->sym_.load(this->map_, trans);
+            this->sym_.peek(first_sink(this->first_));
+        }
+
+        // records the first characters of the keys
+        struct first_sink
+        {
+            explicit first_sink(bool *first)
+              : first_(first)
+            {
+            }
+
+            void operator ()(char_type ch) const
+            {
+                this->first_[static_cast<unsigned char>(ch)] = true;
+            }
+
+            bool *first_;
+        };
+
+        Map const map_;
+        detail::symbols<Map> sym_;
+        traits_type traits_;
+        bool icase_;
+        bool first_[256];
+    };
+
+    /// INTERNAL ONLY
+    ///
+    template<typename OutIter, typename BidiIter, typename Trans>
+    OutIter replace_(OutIter out, BidiIter begin, BidiIter end, flag_type flags, Trans const &trans) const
+    {
+        impl const &that = *this->impl_;
+        bool const yes_copy = (0 == (flags & regex_constants::format_no_copy));
+        BidiIter cur = begin, tmp = begin;
+
+        while(cur != end)
+        {
+            // most positions can be skipped without searching the trie
+            if(!that.first_[static_cast<unsigned char>(trans(*cur))])
+            {
+                ++cur;
+                continue;
+            }
+
+            tmp = cur;
+            mapped_type const *value = that.sym_(tmp, end, trans);
+            if(0 == value || tmp == cur)
+            {
+                ++cur;
+                continue;
+            }
+
+            if(yes_copy)
+            {
+                out = std::copy(begin, cur, out);
+            }
+
+            out = std::copy(boost::begin(*value), boost::end(*value), out);
+            begin = cur = tmp;
+
+            if(0 != (flags & regex_constants::format_first_only))
+            {
+                break;
+            }
+        }
+
+        if(yes_copy)
+        {
+            out = std::copy(begin, end, out);
+        }
+
+        return out;
+    }
+
+    shared_ptr<impl const> impl_;
+};
+
+}} // namespace boost::xpressive
+
+#endif
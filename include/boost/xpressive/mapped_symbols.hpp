@@ -0,0 +1,495 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file mapped_symbols.hpp
+/// Contains the definition of the mapped_symbols\<\> class template, a symbol
+/// table that is built ahead of time and searched where it lies in memory,
+/// for instance in a memory-mapped file.
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_XPRESSIVE_MAPPED_SYMBOLS_HPP_EAN_10_04_2005
+#define BOOST_XPRESSIVE_MAPPED_SYMBOLS_HPP_EAN_10_04_2005
+
+// MS compatible compilers support #pragma once
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+#include <string>
+#include <cstddef>
+#include <utility>
+#include <boost/cstdint.hpp>
+#include <boost/mpl/assert.hpp>
+#include <boost/type_traits/is_pod.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/range/value_type.hpp>
+#include <boost/xpressive/regex_error.hpp>
+#include <boost/xpressive/regex_traits.hpp>
+#include <boost/xpressive/regex_constants.hpp>
+#include <boost/xpressive/detail/core/quant_style.hpp>
+#include <boost/xpressive/detail/core/state.hpp>
+#include <boost/xpressive/detail/core/matcher/attr_matcher.hpp>
+#include <boost/xpressive/detail/utility/symbols.hpp>
+
+namespace boost { namespace xpressive
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// mapped_symbols
+//
+/// \brief Class template mapped_symbols\<\> is a symbol table that is searched
+/// in place, in an image made ahead of time by write().
+///
+/// The image holds the keys in the same ternary search trie that a regex like
+/// <tt>(a1 = map)</tt> builds, with the nodes referring to each other by index,
+/// so it can be written to a file and read or memory-mapped at any address.
+/// The nodes are in breadth-first order, so a node's children always come
+/// after it; searches rely on that, and stop rather than loop or read outside
+/// the image if it is damaged.
+/// Making a mapped_symbols\<\> from an image checks its header and allocates
+/// nothing, however many keys there are. The image must outlive it and all
+/// its copies, and the regexes that use them.
+///
+/// The values are stored in the image as they are in memory, so Value must be
+/// a POD type without pointers; a number that identifies each key is typical.
+/// An image can only be read on a platform with the same byte order, the same
+/// sizeof(Char) and the same sizeof(Value) as the one that wrote it.
+template<typename Char, typename Value = boost::uint32_t>
+struct mapped_symbols
+{
+    BOOST_MPL_ASSERT((is_pod<Value>));
+
+    typedef Char char_type;
+    typedef std::basic_string<Char> key_type;
+    typedef Value mapped_type;
+    typedef std::pair<key_type const, Value> value_type;
+    typedef regex_traits<char_type> traits_type;
+
+    /// Makes a table with no keys.
+    ///
+    mapped_symbols()
+      : nodes_(0)
+      , values_(0)
+      , node_count_(0)
+      , value_count_(0)
+      , root_(0)
+      , empty_(0)
+      , icase_(false)
+      , traits_()
+    {
+    }
+
+    /// \param data The image, as written by write(). It must be aligned for
+    ///             both boost::uint32_t and Value; memory from mmap() or
+    ///             operator new is.
+    /// \param size The size of the image in bytes.
+    /// \throw      regex_error if the image is not one that write() made for
+    ///             this Char and this Value, or if it is cut short.
+    mapped_symbols(void const *data, std::size_t size)
+      : nodes_(0)
+      , values_(0)
+      , node_count_(0)
+      , value_count_(0)
+      , root_(0)
+      , empty_(0)
+      , icase_(false)
+      , traits_()
+    {
+        char const *const begin = static_cast<char const *>(data);
+        bool valid =
+            0 != begin
+         && 0 == reinterpret_cast<std::size_t>(begin) % alignment_
+         && sizeof(header) <= size;
+
+        header const *head = valid ? reinterpret_cast<header const *>(begin) : 0;
+        valid = valid
+         && magic == head->magic
+         && version == head->version
+         && sizeof(Char) == head->char_size
+         && sizeof(Value) == head->value_size
+         && head->total_size <= size
+         && 0 != head->node_count && 0 != head->value_count
+         && head->nodes_offset == sizeof(header)
+         && head->values_offset >= head->nodes_offset
+         && head->values_offset <= head->total_size
+         && 0 == head->values_offset % alignment_
+         && (head->values_offset - head->nodes_offset) / sizeof(node) >= head->node_count
+         && (head->total_size - head->values_offset) / sizeof(Value) >= head->value_count
+         && head->root < head->node_count
+         && head->empty < head->value_count;
+
+        BOOST_XPR_ENSURE_(valid, regex_constants::error_badarg, "invalid symbol table image");
+
+        this->nodes_ = reinterpret_cast<node const *>(begin + head->nodes_offset);
+        this->values_ = reinterpret_cast<Value const *>(begin + head->values_offset);
+        this->node_count_ = head->node_count;
+        this->value_count_ = head->value_count;
+        this->root_ = head->root;
+        this->empty_ = head->empty;
+        this->icase_ = 0 != (head->flags & icase_flag);
+    }
+
+    /// Writes an image of map, for the constructor to use later.
+    ///
+    /// \param out   An output iterator that chars can be written to, such as
+    ///              std::ostreambuf_iterator\<char\>.
+    /// \param map   The keys, which are strings of Char, and their values,
+    ///              which must convert to Value.
+    /// \param flags If flags \& icase, keys will be found regardless of case.
+    /// \return      The output iterator after the last char written.
+    /// \throw       regex_error if the image would be too large.
+    template<typename OutIter, typename Map>
+    static OutIter write(OutIter out, Map const &map, regex_constants::syntax_option_type flags = regex_constants::ECMAScript)
+    {
+        typedef typename range_value<Map>::type::first_type map_key_type;
+        BOOST_MPL_ASSERT((is_same<typename range_value<map_key_type>::type, Char>));
+
+        bool const icase = 0 != (flags & regex_constants::icase_);
+        traits_type traits;
+        detail::symbols<Map> sym;
+        if(icase)
+        {
+            sym.load(map, detail::char_translate<traits_type, true>(traits));
+        }
+        else
+        {
+            sym.load(map, detail::char_translate<traits_type, false>(traits));
+        }
+
+        writer<OutIter, Map> w(out, icase);
+        sym.visit(w);
+        return w.finish();
+    }
+
+    /// The number of keys.
+    ///
+    std::size_t size() const
+    {
+        return 0 == this->value_count_ ? 0 : this->value_count_ - 1;
+    }
+
+    /// Finds the longest key that begins at begin.
+    ///
+    /// \param begin The beginning of the input sequence. If a key is found,
+    ///              begin is moved past it.
+    /// \param end   The end of the input sequence.
+    /// \return      The key's value, or null if no key begins at begin.
+    template<typename BidiIter>
+    Value const *find(BidiIter &begin, BidiIter end) const
+    {
+        if(this->icase_)
+        {
+            return this->find_(begin, end, detail::char_translate<traits_type, true>(this->traits_));
+        }
+        return this->find_(begin, end, detail::char_translate<traits_type, false>(this->traits_));
+    }
+
+    /// INTERNAL ONLY
+    ///
+    template<typename Bitset, typename Traits>
+    void peek(Bitset &bset, Traits const &tr) const
+    {
+        if(0 != this->empty_)
+        {
+            bset.set_all();
+            return;
+        }
+
+        // the first characters of the keys are the first binary search tree,
+        // which is balanced, so the stack is deep enough for any image that
+        // write() made
+        boost::uint32_t stack[64];
+        std::size_t size = 0;
+        for(boost::uint32_t p = this->root_; 0 != p || 0 != size;)
+        {
+            if(0 == p)
+            {
+                p = stack[--size];
+            }
+
+            node const &n = this->nodes_[p];
+            bset.set_char(char_(n.ch), this->icase_, tr);
+            if(this->is_child_(p, n.hi))
+            {
+                if(size == sizeof(stack) / sizeof(*stack))
+                {
+                    bset.set_all();
+                    return;
+                }
+                stack[size++] = n.hi;
+            }
+            p = this->is_child_(p, n.lo) ? n.lo : 0;
+        }
+    }
+
+private:
+    typedef std::char_traits<Char> char_traits_type;
+
+    BOOST_STATIC_CONSTANT(boost::uint32_t, magic = 0x4D595358); // "XSYM", in this byte order
+    BOOST_STATIC_CONSTANT(boost::uint32_t, version = 1);
+    BOOST_STATIC_CONSTANT(boost::uint32_t, icase_flag = 1);
+    BOOST_STATIC_CONSTANT(std::size_t, alignment_ =
+        alignment_of<Value>::value < 4 ? 4 : alignment_of<Value>::value);
+
+    /// INTERNAL ONLY
+    ///
+    struct header
+    {
+        boost::uint32_t magic;
+        boost::uint32_t version;
+        boost::uint32_t char_size;
+        boost::uint32_t value_size;
+        boost::uint32_t flags;
+        boost::uint32_t node_count;    // including the unused node 0
+        boost::uint32_t value_count;   // including the unused value 0
+        boost::uint32_t root;
+        boost::uint32_t empty;         // the value of the empty key, or 0
+        boost::uint32_t nodes_offset;  // in bytes, from the start of the image
+        boost::uint32_t values_offset;
+        boost::uint32_t total_size;
+        boost::uint32_t reserved[4];
+    };
+
+    /// INTERNAL ONLY
+    ///
+    struct node
+    {
+        boost::uint32_t ch;
+        boost::uint32_t lo;
+        boost::uint32_t eq;
+        boost::uint32_t hi;
+        boost::uint32_t result;
+    };
+
+    static boost::uint32_t ch_(Char ch)
+    {
+        return static_cast<boost::uint32_t>(char_traits_type::to_int_type(ch));
+    }
+
+    static Char char_(boost::uint32_t ch)
+    {
+        return char_traits_type::to_char_type(static_cast<typename char_traits_type::int_type>(ch));
+    }
+
+    /// INTERNAL ONLY
+    ///
+    template<typename OutIter, typename Map>
+    struct writer
+    {
+        typedef typename detail::symbols<Map>::result_type result_type;
+        typedef typename mapped_symbols::node node_type;
+
+        writer(OutIter out, bool icase)
+          : out_(out)
+          , head_()
+          , offset_(0)
+          , empty_(0)
+        {
+            this->head_.magic = magic;
+            this->head_.version = version;
+            this->head_.char_size = sizeof(Char);
+            this->head_.value_size = sizeof(Value);
+            this->head_.flags = icase ? icase_flag : 0;
+        }
+
+        void start(std::size_t nodes, std::size_t results, boost::uint32_t root, result_type empty)
+        {
+            // the value of the empty key goes after the others
+            std::size_t const values = results + (empty ? 1 : 0);
+            std::size_t const max_size = 0xFFFFFFFFu;
+            BOOST_XPR_ENSURE_
+            (
+                nodes < (max_size - sizeof(header) - alignment_) / sizeof(node_type)
+             && values < (max_size - sizeof(header) - alignment_ - (nodes + 1) * sizeof(node_type)) / sizeof(Value)
+              , regex_constants::error_space
+              , "symbol table image too large"
+            );
+
+            std::size_t const values_offset =
+                (sizeof(header) + (nodes + 1) * sizeof(node_type) + alignment_ - 1) / alignment_ * alignment_;
+            this->head_.node_count = static_cast<boost::uint32_t>(nodes + 1);
+            this->head_.value_count = static_cast<boost::uint32_t>(values + 1);
+            this->head_.root = root;
+            this->head_.empty = empty ? static_cast<boost::uint32_t>(values) : 0;
+            this->head_.nodes_offset = sizeof(header);
+            this->head_.values_offset = static_cast<boost::uint32_t>(values_offset);
+            this->head_.total_size = static_cast<boost::uint32_t>(values_offset + (values + 1) * sizeof(Value));
+            this->empty_ = empty;
+
+            this->put_(&this->head_, sizeof(header));
+            node_type const none = {0, 0, 0, 0, 0};
+            this->put_(&none, sizeof(node_type));
+        }
+
+        void node(Char ch, boost::uint32_t lo, boost::uint32_t eq, boost::uint32_t hi, boost::uint32_t result)
+        {
+            node_type const n = {ch_(ch), lo, eq, hi, result};
+            this->put_(&n, sizeof(node_type));
+        }
+
+        void result(result_type r)
+        {
+            this->pad_();
+            this->value_(*r);
+        }
+
+        OutIter finish()
+        {
+            this->pad_();
+            if(this->empty_)
+            {
+                this->value_(*this->empty_);
+            }
+            return this->out_;
+        }
+
+    private:
+        // once the nodes are written, pads to the values and writes the
+        // unused value 0
+        void pad_()
+        {
+            if(this->offset_ > this->head_.values_offset)
+            {
+                return;
+            }
+            for(; this->offset_ < this->head_.values_offset; ++this->offset_)
+            {
+                *this->out_++ = char(0);
+            }
+            this->value_(Value());
+        }
+
+        template<typename From>
+        void value_(From const &from)
+        {
+            Value const value = static_cast<Value>(from);
+            this->put_(&value, sizeof(Value));
+        }
+
+        void put_(void const *data, std::size_t size)
+        {
+            char const *bytes = static_cast<char const *>(data);
+            for(std::size_t i = 0; i != size; ++i)
+            {
+                *this->out_++ = bytes[i];
+            }
+            this->offset_ += size;
+        }
+
+        OutIter out_;
+        header head_;
+        std::size_t offset_;
+        result_type empty_;
+    };
+
+    // whether child is a node that parent can link to
+    bool is_child_(boost::uint32_t parent, boost::uint32_t child) const
+    {
+        return parent < child && child < this->node_count_;
+    }
+
+    template<typename BidiIter, typename Trans>
+    Value const *find_(BidiIter &begin, BidiIter end, Trans const &trans) const
+    {
+        if(begin == end)
+        {
+            return 0 == this->empty_ ? 0 : this->values_ + this->empty_;
+        }
+
+        boost::uint32_t r = 0;
+        BidiIter cur = begin;
+        Char c1 = trans(*cur);
+        boost::uint32_t p = this->root_ < this->node_count_ ? this->root_ : 0;
+
+        // a link to a node that isn't a child ends the search, so no image
+        // can make it loop or read outside the image
+        while(0 != p)
+        {
+            node const &n = this->nodes_[p];
+            Char const ch = char_(n.ch);
+            boost::uint32_t next = 0;
+            if(c1 == ch)
+            {
+                if(0 != n.result && n.result < this->value_count_)
+                {
+                    // it's a match! keep looking for a longer one
+                    r = n.result;
+                    begin = cur;
+                    ++begin;
+                }
+                if(++cur == end)
+                    break;
+                c1 = trans(*cur);
+                next = n.eq;
+            }
+            else if(c1 < ch)
+            {
+                next = n.lo;
+            }
+            else // (c1 > ch)
+            {
+                next = n.hi;
+            }
+            p = this->is_child_(p, next) ? next : 0;
+        }
+
+        return 0 == r ? 0 : this->values_ + r;
+    }
+
+    node const *nodes_;
+    Value const *values_;
+    boost::uint32_t node_count_;
+    boost::uint32_t value_count_;
+    boost::uint32_t root_;
+    boost::uint32_t empty_;
+    bool icase_;
+    traits_type traits_;
+};
+
+namespace detail
+{
+    ///////////////////////////////////////////////////////////////////////////////
+    // attr_matcher
+    //  Note: the Matcher is a mapped_symbols; it decides for itself whether
+    //  case matters.
+    template<typename Char, typename Value, typename Traits, typename ICase>
+    struct attr_matcher<mapped_symbols<Char, Value>, Traits, ICase>
+      : quant_style<quant_none, 0, false>
+    {
+        typedef Value const *result_type;
+
+        attr_matcher(int slot, mapped_symbols<Char, Value> const &sym, Traits const &)
+          : slot_(slot-1)
+          , sym_(sym)
+        {
+        }
+
+        template<typename BidiIter, typename Next>
+        bool match(match_state<BidiIter> &state, Next const &next) const
+        {
+            BidiIter tmp = state.cur_;
+            result_type result = this->sym_.find(state.cur_, state.end_);
+            if(result)
+            {
+                void const *old_slot = state.attr_context_.attr_slots_[this->slot_];
+                state.attr_context_.attr_slots_[this->slot_] = result;
+                if(next.match(state))
+                {
+                    return true;
+                }
+                state.attr_context_.attr_slots_[this->slot_] = old_slot;
+            }
+            state.cur_ = tmp;
+            return false;
+        }
+
+        int slot_;
+        mapped_symbols<Char, Value> sym_;
+    };
+}
+
+}} // namespace boost::xpressive
+
+#endif
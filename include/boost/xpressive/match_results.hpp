@@ -46,6 +46,7 @@
 #include <boost/range/as_literal.hpp>
 #include <boost/range/const_iterator.hpp>
 #include <boost/type_traits/is_function.hpp>
+#include <boost/type_traits/is_pointer.hpp>
 #if BOOST_ITERATOR_ADAPTORS_VERSION >= 0x0200
 # include <boost/iterator/filter_iterator.hpp>
 #endif
@@ -55,27 +56,85 @@
 #include <boost/xpressive/detail/core/sub_match_vector.hpp>
 #include <boost/xpressive/detail/utility/sequence_stack.hpp>
 #include <boost/xpressive/detail/core/results_cache.hpp>
+#include <boost/xpressive/detail/core/memo_table.hpp>
 #include <boost/xpressive/detail/utility/literals.hpp>
 #include <boost/xpressive/detail/utility/algorithm.hpp>
 #include <boost/xpressive/detail/utility/counted_base.hpp>
+#include <boost/xpressive/detail/utility/byte_allocator.hpp>
+#include <boost/xpressive/detail/utility/thread_local_pool.hpp>
 // Doxygen can't handle proto :-(
 #ifndef BOOST_XPRESSIVE_DOXYGEN_INVOKED
 # include <boost/proto/proto_fwd.hpp>
 # include <boost/proto/traits.hpp>
 #endif
 
+/// The default for match_results\<\>::max_retained_bytes(). If not defined,
+/// match_results\<\> objects keep all the memory they have ever needed.
+#ifndef BOOST_XPRESSIVE_MAX_RETAINED_BYTES
+# define BOOST_XPRESSIVE_MAX_RETAINED_BYTES (~static_cast<std::size_t>(0))
+#endif
+
 namespace boost { namespace xpressive { namespace detail
 {
 
 ///////////////////////////////////////////////////////////////////////////////
-// type_info_less
-//
-struct type_info_less
+// action_args
+//   The objects bound to action arguments with let(), keyed by the type_info
+//   of the argument placeholder. There are seldom more than a few, and every
+//   action that uses one looks it up, so they are kept in one contiguous
+//   block and searched by address before falling back on type_info equality.
+struct action_args
 {
-    bool operator()(std::type_info const *left, std::type_info const *right) const
+    typedef std::pair<std::type_info const *, void *> value_type;
+    typedef std::vector<value_type>::const_iterator const_iterator;
+
+    const_iterator find(std::type_info const *type) const
     {
-        return 0 != left->before(*right);
+        return this->args_.begin() + this->index_(type);
     }
+
+    const_iterator end() const
+    {
+        return this->args_.end();
+    }
+
+    void *&operator [](std::type_info const *type)
+    {
+        std::size_t index = this->index_(type);
+        if(index == this->args_.size())
+        {
+            this->args_.push_back(value_type(type, static_cast<void *>(0)));
+        }
+        return this->args_[index].second;
+    }
+
+    void swap(action_args &that)
+    {
+        this->args_.swap(that.args_);
+    }
+
+private:
+    std::size_t index_(std::type_info const *type) const
+    {
+        std::size_t const size = this->args_.size();
+        for(std::size_t i = 0; i != size; ++i)
+        {
+            if(this->args_[i].first == type)
+            {
+                return i;
+            }
+        }
+        for(std::size_t i = 0; i != size; ++i)
+        {
+            if(*this->args_[i].first == *type)
+            {
+                return i;
+            }
+        }
+        return size;
+    }
+
+    std::vector<value_type> args_;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -93,8 +152,96 @@ template<typename BidiIter>
 struct results_extras
   : counted_base<results_extras<BidiIter> >
 {
+    // Room for this many sub-matches is allocated along with the
+    // results_extras, so a regex with only a few groups needs no more.
+    BOOST_STATIC_CONSTANT(std::size_t, inline_sub_matches = 16);
+
+    explicit results_extras(byte_allocator *alloc = 0)
+      : alloc_(alloc)
+      , max_retained_bytes_(BOOST_XPRESSIVE_MAX_RETAINED_BYTES)
+      , sub_match_stack_(alloc, &sub_match_seed_, sizeof(sub_match_seed_))
+      , results_cache_(alloc)
+      , memo_(alloc)
+    {
+    }
+
+    std::size_t retained_bytes() const
+    {
+        return sizeof(results_extras)
+            + this->sub_match_stack_.retained_bytes()
+            + this->results_cache_.retained_bytes()
+            + this->memo_.retained_bytes();
+    }
+
+    // Called between matches, when nothing is in use but the sub-matches of
+    // the next match. Gives up the memo table first, then cached results,
+    // then sub-match chunks.
+    void trim()
+    {
+        if(this->retained_bytes() > this->max_retained_bytes_)
+        {
+            this->memo_.release();
+            std::size_t budget = this->max_retained_bytes_ > sizeof(results_extras)
+                ? this->max_retained_bytes_ - sizeof(results_extras)
+                : 0;
+            std::size_t stack = this->sub_match_stack_.retained_bytes();
+            this->results_cache_.trim(budget > stack ? budget - stack : 0);
+            std::size_t cache = this->results_cache_.retained_bytes();
+            this->sub_match_stack_.trim(budget > cache ? budget - cache : 0);
+        }
+    }
+
+    // Called before a results_extras from the global heap goes back into the
+    // thread-local pool, so the next owner starts out with a warm but empty one.
+    void recycle()
+    {
+        this->sub_match_stack_.unwind();
+        this->max_retained_bytes_ = BOOST_XPRESSIVE_MAX_RETAINED_BYTES;
+        this->trim();
+    }
+
+    intrusive_ptr<byte_allocator> alloc_;
+    std::size_t max_retained_bytes_;
+    typename sequence_stack<sub_match_impl<BidiIter> >::template seed_buffer<inline_sub_matches> sub_match_seed_;
     sequence_stack<sub_match_impl<BidiIter> > sub_match_stack_;
     results_cache<BidiIter> results_cache_;
+    memo_table memo_;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// counted_base_access
+//   results_extras lives in memory obtained from its own allocator, so it
+//   must be freed with it rather than with delete.
+template<typename BidiIter>
+struct counted_base_access<results_extras<BidiIter> >
+{
+    static void add_ref(counted_base<results_extras<BidiIter> > const *that)
+    {
+        ++that->count_;
+    }
+
+    static void release(counted_base<results_extras<BidiIter> > const *that)
+    {
+        BOOST_ASSERT(0 < that->count_);
+        if(0 == --that->count_)
+        {
+            results_extras<BidiIter> *extras =
+                const_cast<results_extras<BidiIter> *>(static_cast<results_extras<BidiIter> const *>(that));
+#ifdef BOOST_XPRESSIVE_HAS_THREAD_LOCAL_POOL
+            if(!extras->alloc_)
+            {
+                extras->recycle();
+                if(thread_local_pool<results_extras<BidiIter>, 4>::release(extras))
+                {
+                    return;
+                }
+            }
+#endif
+            // keep the allocator alive until the extras are gone
+            intrusive_ptr<byte_allocator> alloc(extras->alloc_);
+            delete_with(alloc.get(), extras);
+        }
+    }
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -390,6 +537,7 @@ public:
       , base_()
       , prefix_()
       , suffix_()
+      , alloc_()
       , nested_results_()
       , extras_ptr_()
       , traits_()
@@ -398,6 +546,45 @@ public:
     {
     }
 
+    /// \param alloc The allocator from which to obtain the memory for the
+    ///        sub-match and nested result storage.
+    /// \post regex_id() == 0
+    /// \post size()     == 0
+    /// \post empty()    == true
+    /// \post str()      == string_type()
+    template<typename Alloc>
+    explicit match_results(Alloc const &alloc, typename disable_if<is_pointer<Alloc> >::type * = 0)
+      : regex_id_(0)
+      , sub_matches_()
+      , base_()
+      , prefix_()
+      , suffix_()
+      , alloc_(detail::byte_allocator_impl<Alloc>::make(alloc))
+      , nested_results_(alloc_.get())
+      , extras_ptr_()
+      , traits_()
+      , args_()
+      , named_marks_()
+    {
+    }
+
+    /// INTERNAL ONLY
+    ///
+    explicit match_results(detail::byte_allocator *alloc)
+      : regex_id_(0)
+      , sub_matches_()
+      , base_()
+      , prefix_()
+      , suffix_()
+      , alloc_(alloc)
+      , nested_results_(alloc)
+      , extras_ptr_()
+      , traits_()
+      , args_()
+      , named_marks_()
+    {
+    }
+
     /// \param that The match_results object to copy
     /// \post regex_id()  == that.regex_id().
     /// \post size()      == that.size().
@@ -414,27 +601,38 @@ public:
       , base_()
       , prefix_()
       , suffix_()
+      , alloc_()
       , nested_results_()
       , extras_ptr_()
       , traits_()
       , args_(that.args_)
       , named_marks_(that.named_marks_)
     {
-        if(that)
-        {
-            extras_type &extras = this->get_extras_();
-            std::size_t size = that.sub_matches_.size();
-            detail::sub_match_impl<BidiIter> *sub_matches = extras.sub_match_stack_.push_sequence(size, detail::sub_match_impl<BidiIter>(*that.base_), detail::fill);
-            detail::core_access<BidiIter>::init_sub_match_vector(this->sub_matches_, sub_matches, size, that.sub_matches_);
+        this->copy_(that);
+    }
 
-            this->base_ = that.base_;
-            this->prefix_ = that.prefix_;
-            this->suffix_ = that.suffix_;
-            // BUGBUG this doesn't share the extras::sequence_stack
-            this->nested_results_ = that.nested_results_;
-            this->traits_ = that.traits_;
-        }
+    #ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+    /// \param that The match_results object to move from. Nested results are
+    ///        moved, not copied.
+    /// \post *this contains the results that were in that.
+    /// \post that.size() == 0
+    /// \throw nothrow
+    match_results(match_results<BidiIter> &&that) BOOST_NOEXCEPT
+      : regex_id_(0)
+      , sub_matches_()
+      , base_()
+      , prefix_()
+      , suffix_()
+      , alloc_()
+      , nested_results_()
+      , extras_ptr_()
+      , traits_()
+      , args_()
+      , named_marks_()
+    {
+        this->swap(that);
     }
+    #endif
 
     ~match_results()
     {
@@ -452,9 +650,33 @@ public:
     /// \post position(n) == that.position(n) for all positive integers n \< that.size().
     match_results<BidiIter> &operator =(match_results<BidiIter> const &that)
     {
-        match_results<BidiIter>(that).swap(*this);
+        // keep this object's allocator
+        match_results<BidiIter> tmp(this->alloc_.get());
+        tmp.regex_id_ = that.regex_id_;
+        tmp.args_ = that.args_;
+        tmp.named_marks_ = that.named_marks_;
+        if(this->extras_ptr_)
+        {
+            tmp.max_retained_bytes(this->max_retained_bytes());
+        }
+        tmp.copy_(that);
+        tmp.swap(*this);
+        return *this;
+    }
+
+    #ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+    /// Unlike copy assignment, this takes the allocator of that along with its
+    /// contents.
+    /// \param that The match_results object to move from.
+    /// \post *this contains the results that were in that.
+    /// \throw nothrow
+    /// \return *this
+    match_results<BidiIter> &operator =(match_results<BidiIter> &&that) BOOST_NOEXCEPT
+    {
+        this->swap(that);
         return *this;
     }
+    #endif
 
     /// Returns one plus the number of marked sub-expressions in the regular
     /// expression that was matched if *this represents the result of a
@@ -493,6 +715,16 @@ public:
         return this->sub_matches_[ sub ].str();
     }
 
+#ifndef BOOST_NO_CXX17_HDR_STRING_VIEW
+    /// Returns (*this)[sub].view().
+    ///
+    /// \pre BidiIter is a contiguous iterator.
+    typename sub_match<BidiIter>::string_view_type view(size_type sub = 0) const
+    {
+        return this->sub_matches_[ sub ].view();
+    }
+#endif
+
     /// Returns a reference to the sub_match object representing the sequence that
     /// matched marked sub-expression sub. If sub == 0 then returns a reference to
     /// a sub_match object representing the sequence that matched the whole regular
@@ -566,6 +798,31 @@ public:
         return this->nested_results_;
     }
 
+    /// Returns the number of bytes of memory this object keeps for sub-matches and
+    /// for reuse by later matches. The nested results of the current match are not
+    /// counted.
+    size_type retained_bytes() const
+    {
+        return this->extras_ptr_ ? this->extras_ptr_->retained_bytes() : 0;
+    }
+
+    /// Returns the limit set by max_retained_bytes(size_type), or
+    /// BOOST_XPRESSIVE_MAX_RETAINED_BYTES if none has been set.
+    size_type max_retained_bytes() const
+    {
+        return this->extras_ptr_ ? this->extras_ptr_->max_retained_bytes_ : BOOST_XPRESSIVE_MAX_RETAINED_BYTES;
+    }
+
+    /// Limits the memory that is kept from one match to the next. Before each match,
+    /// cached memory is freed until retained_bytes() is no more than \c bytes,
+    /// or nothing more can be freed.
+    /// \param bytes The high-water mark.
+    /// \post max_retained_bytes() == bytes
+    void max_retained_bytes(size_type bytes)
+    {
+        this->get_extras_().max_retained_bytes_ = bytes;
+    }
+
     /// If \c Format models \c ForwardRange or is a null-terminated string, this function
     /// copies the character sequence in \c fmt to \c OutputIterator \c out. For each format
     /// specifier or escape sequence in \c fmt, replace that sequence with either the character(s) it
@@ -633,7 +890,7 @@ public:
     ///
     /// Otherwise, if \c Format models <tt>Callable\<match_results\<BidiIter\> \></tt>, this function
     /// returns <tt>fmt(*this)</tt>.
-    template<typename Format, typename OutputIterator>
+    template<typename Format>
     string_type format
     (
         Format const &fmt
@@ -672,10 +929,12 @@ public:
         this->base_.swap(that.base_);
         this->prefix_.swap(that.prefix_);
         this->suffix_.swap(that.suffix_);
+        this->alloc_.swap(that.alloc_);
         this->nested_results_.swap(that.nested_results_);
         this->extras_ptr_.swap(that.extras_ptr_);
         this->traits_.swap(that.traits_);
         this->args_.swap(that.args_);
+        this->named_marks_.swap(that.named_marks_);
     }
 
     /// TODO document me
@@ -729,22 +988,62 @@ private:
       , intrusive_ptr<detail::traits<char_type> const> const &tr
       , detail::sub_match_impl<BidiIter> *sub_matches
       , size_type size
-      , std::vector<detail::named_mark<char_type> > const &named_marks
+      , intrusive_ptr<detail::named_marks<char_type> > const &named_marks
     )
     {
-        this->traits_ = tr;
+        // Avoid bumping the shared reference count when the traits
+        // object hasn't changed since the last match.
+        if(this->traits_ != tr)
+        {
+            this->traits_ = tr;
+        }
         this->regex_id_ = regex_id;
-        this->named_marks_ = named_marks;
+        if(this->named_marks_ != named_marks)
+        {
+            this->named_marks_ = named_marks;
+        }
         detail::core_access<BidiIter>::init_sub_match_vector(this->sub_matches_, sub_matches, size);
     }
 
+    /// INTERNAL ONLY
+    ///
+    void copy_(match_results<BidiIter> const &that)
+    {
+        if(that)
+        {
+            extras_type &extras = this->get_extras_();
+            std::size_t size = that.sub_matches_.size();
+            detail::sub_match_impl<BidiIter> *sub_matches = extras.sub_match_stack_.push_sequence(size, detail::sub_match_impl<BidiIter>(*that.base_), detail::fill);
+            detail::core_access<BidiIter>::init_sub_match_vector(this->sub_matches_, sub_matches, size, that.sub_matches_);
+
+            this->base_ = that.base_;
+            this->prefix_ = that.prefix_;
+            this->suffix_ = that.suffix_;
+            // BUGBUG this doesn't share the extras::sequence_stack
+            // The nested results use this object's allocator, so that they can
+            // later be reclaimed into its results_cache.
+            typename nested_results_type::const_iterator it = that.nested_results_.begin(), e = that.nested_results_.end();
+            for(; it != e; ++it)
+            {
+                this->nested_results_.push_back(this->alloc_.get());
+                this->nested_results_.back() = *it;
+            }
+            this->traits_ = that.traits_;
+        }
+    }
+
     /// INTERNAL ONLY
     ///
     extras_type &get_extras_()
     {
         if(!this->extras_ptr_)
         {
-            this->extras_ptr_ = new extras_type;
+            extras_type *extras = 0;
+#ifdef BOOST_XPRESSIVE_HAS_THREAD_LOCAL_POOL
+            // results_extras from the global heap can be reused within a thread
+            extras = this->alloc_ ? 0 : detail::thread_local_pool<extras_type, 4>::acquire();
+#endif
+            this->extras_ptr_ = extras ? extras : detail::new_with<extras_type>(this->alloc_.get(), this->alloc_.get());
         }
 
         return *this->extras_ptr_;
@@ -805,11 +1104,11 @@ private:
     ///
     const_reference at_(char_type const *name) const
     {
-        for(std::size_t i = 0; i < this->named_marks_.size(); ++i)
+        if(this->named_marks_)
         {
-            if(this->named_marks_[i].name_ == name)
+            if(detail::named_mark<char_type> const *mark = this->named_marks_->find(name))
             {
-                return this->sub_matches_[ this->named_marks_[i].mark_nbr_ ];
+                return this->sub_matches_[ mark->mark_nbr_ ];
             }
         }
         BOOST_THROW_EXCEPTION(
@@ -1332,12 +1631,12 @@ private:
         BOOST_XPR_ENSURE_(cur != begin && cur != end && BOOST_XPR_CHAR_(char_type, '>') == *cur
             , error_badmark, "invalid named back-reference");
 
-        string_type name(begin, cur++);
-        for(std::size_t i = 0; i < this->named_marks_.size(); ++i)
+        ForwardIterator name_end = cur++;
+        if(this->named_marks_)
         {
-            if(this->named_marks_[i].name_ == name)
+            if(detail::named_mark<char_type> const *mark = this->named_marks_->find(begin, name_end))
             {
-                std::size_t sub = this->named_marks_[i].mark_nbr_;
+                std::size_t sub = mark->mark_nbr_;
                 return std::copy(this->sub_matches_[ sub ].first, this->sub_matches_[ sub ].second, out);
             }
         }
@@ -1352,11 +1651,12 @@ private:
     boost::optional<BidiIter> base_;
     boost::optional<sub_match<BidiIter> > prefix_;
     boost::optional<sub_match<BidiIter> > suffix_;
+    intrusive_ptr<detail::byte_allocator> alloc_;
     nested_results_type nested_results_;
     intrusive_ptr<extras_type> extras_ptr_;
     intrusive_ptr<detail::traits<char_type> const> traits_;
     detail::action_args_type args_;
-    std::vector<detail::named_mark<char_type> > named_marks_;
+    intrusive_ptr<detail::named_marks<char_type> const> named_marks_;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
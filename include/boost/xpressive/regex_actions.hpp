@@ -14,12 +14,14 @@
 # pragma once
 #endif
 
+#include <limits>
 #include <boost/config.hpp>
 #include <boost/preprocessor/punctuation/comma_if.hpp>
 #include <boost/ref.hpp>
 #include <boost/mpl/if.hpp>
 #include <boost/mpl/or.hpp>
 #include <boost/mpl/int.hpp>
+#include <boost/mpl/bool.hpp>
 #include <boost/mpl/assert.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/lexical_cast.hpp>
@@ -28,6 +30,7 @@
 #include <boost/type_traits/is_same.hpp>
 #include <boost/type_traits/is_const.hpp>
 #include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
 #include <boost/type_traits/decay.hpp>
 #include <boost/type_traits/remove_cv.hpp>
 #include <boost/type_traits/remove_reference.hpp>
@@ -38,6 +41,7 @@
 #include <boost/xpressive/detail/core/matcher/attr_end_matcher.hpp>
 #include <boost/xpressive/detail/core/matcher/attr_begin_matcher.hpp>
 #include <boost/xpressive/detail/core/matcher/predicate_matcher.hpp>
+#include <boost/xpressive/detail/utility/literals.hpp>
 #include <boost/xpressive/detail/utility/ignore_unused.hpp>
 #include <boost/xpressive/detail/static/type_traits.hpp>
 
@@ -148,6 +152,68 @@ namespace boost { namespace xpressive
         }
 
         typedef boost::proto::functional::make_expr<proto::tag::function, proto::default_domain> make_function;
+
+        // The integer types that as<> parses itself. Character types are
+        // excluded because lexical_cast treats them as characters.
+        template<typename T>
+        struct is_parsed_integer
+          : mpl::bool_<
+                is_integral<T>::value
+             && !is_same<T, bool>::value
+             && !is_char<T>::value
+             && !is_same<T, signed char>::value
+             && !is_same<T, unsigned char>::value
+            #ifndef BOOST_NO_CXX11_CHAR16_T
+             && !is_same<T, char16_t>::value
+            #endif
+            #ifndef BOOST_NO_CXX11_CHAR32_T
+             && !is_same<T, char32_t>::value
+            #endif
+            >
+        {};
+
+        // Converts [begin, end) to an integer without going through a stream.
+        // Only an optional sign followed by decimal digits is accepted, and the
+        // value must fit; anything else returns false and is left to lexical_cast.
+        template<typename Int, typename FwdIter>
+        bool parse_integer(FwdIter begin, FwdIter end, Int &result)
+        {
+            typedef typename iterator_value<FwdIter>::type char_type;
+            typedef typename make_unsigned<Int>::type uint_type;
+
+            bool neg = false;
+            if(begin != end && (*begin == BOOST_XPR_CHAR_(char_type, '-') || *begin == BOOST_XPR_CHAR_(char_type, '+')))
+            {
+                neg = (*begin == BOOST_XPR_CHAR_(char_type, '-'));
+                ++begin;
+            }
+
+            if(begin == end || (neg && !std::numeric_limits<Int>::is_signed))
+            {
+                return false;
+            }
+
+            uint_type const limit = static_cast<uint_type>((std::numeric_limits<Int>::max)()) + (neg ? 1u : 0u);
+            uint_type value = 0;
+            for(; begin != end; ++begin)
+            {
+                if(*begin < BOOST_XPR_CHAR_(char_type, '0') || BOOST_XPR_CHAR_(char_type, '9') < *begin)
+                {
+                    return false;
+                }
+
+                uint_type digit = static_cast<uint_type>(*begin - BOOST_XPR_CHAR_(char_type, '0'));
+                if(value > (limit - digit) / 10u)
+                {
+                    return false;
+                }
+
+                value = static_cast<uint_type>(value * 10u + digit);
+            }
+
+            result = (neg && 0 != value) ? static_cast<Int>(-static_cast<Int>(value - 1u) - 1) : static_cast<Int>(value);
+            return true;
+        }
     }
 
     namespace op
@@ -686,25 +752,6 @@ namespace boost { namespace xpressive
                 return boost::lexical_cast<T>(val);
             }
 
-            // Hack around some limitations in boost::lexical_cast
-            /// INTERNAL ONLY
-            T operator()(csub_match const &val) const
-            {
-                return val.matched
-                  ? boost::lexical_cast<T>(boost::make_iterator_range(val.first, val.second))
-                  : boost::lexical_cast<T>("");
-            }
-
-            #ifndef BOOST_XPRESSIVE_NO_WREGEX
-            /// INTERNAL ONLY
-            T operator()(wcsub_match const &val) const
-            {
-                return val.matched
-                  ? boost::lexical_cast<T>(boost::make_iterator_range(val.first, val.second))
-                  : boost::lexical_cast<T>("");
-            }
-            #endif
-
             /// INTERNAL ONLY
             template<typename BidiIter>
             T operator()(sub_match<BidiIter> const &val) const
@@ -717,15 +764,33 @@ namespace boost { namespace xpressive
                   , CAN_ONLY_CONVERT_FROM_CHARACTER_SEQUENCES
                   , (char_type)
                 );
-                return this->impl(val, xpressive::detail::is_string_iterator<BidiIter>());
+                return this->convert(val, xpressive::detail::is_parsed_integer<T>());
             }
 
         private:
+            /// INTERNAL ONLY
+            template<typename BidiIter>
+            T convert(sub_match<BidiIter> const &val, mpl::true_) const
+            {
+                // Plain decimal integers are common enough to skip lexical_cast.
+                T result = T();
+                return val.matched && xpressive::detail::parse_integer(val.first, val.second, result)
+                  ? result
+                  : this->convert(val, mpl::false_());
+            }
+
+            /// INTERNAL ONLY
+            template<typename BidiIter>
+            T convert(sub_match<BidiIter> const &val, mpl::false_) const
+            {
+                return this->impl(val, xpressive::detail::is_contiguous<BidiIter>());
+            }
+
             /// INTERNAL ONLY
             template<typename RandIter>
             T impl(sub_match<RandIter> const &val, mpl::true_) const
             {
-                return val.matched
+                return val.matched && val.first != val.second
                   ? boost::lexical_cast<T>(boost::make_iterator_range(&*val.first, &*val.first + (val.second - val.first)))
                   : boost::lexical_cast<T>("");
             }
@@ -15,18 +15,24 @@
 #endif
 
 #include <string>
+#include <cstring>
 #include <iterator>
+#include <algorithm>
 #include <boost/mpl/or.hpp>
+#include <boost/mpl/and.hpp>
+#include <boost/mpl/bool.hpp>
 #include <boost/range/end.hpp>
 #include <boost/range/begin.hpp>
 #include <boost/mpl/identity.hpp>
 #include <boost/utility/enable_if.hpp>
 #include <boost/type_traits/add_const.hpp>
+#include <boost/type_traits/is_same.hpp>
 #include <boost/type_traits/is_pointer.hpp>
 #include <boost/type_traits/remove_const.hpp>
 #include <boost/xpressive/match_results.hpp>
 #include <boost/xpressive/detail/detail_fwd.hpp>
 #include <boost/xpressive/detail/core/state.hpp>
+#include <boost/xpressive/detail/static/type_traits.hpp>
 #include <boost/xpressive/detail/utility/save_restore.hpp>
 
 /// INTERNAL ONLY
@@ -47,21 +53,17 @@ namespace detail
     template<typename BidiIter>
     inline bool regex_match_impl
     (
-        BOOST_XPR_NONDEDUCED_TYPE_(BidiIter) begin
-      , BOOST_XPR_NONDEDUCED_TYPE_(BidiIter) end
-      , match_results<BidiIter> &what
+        match_state<BidiIter> &state
       , basic_regex<BidiIter> const &re
-      , regex_constants::match_flag_type flags = regex_constants::match_default
     )
     {
-        typedef detail::core_access<BidiIter> access;
+        typedef core_access<BidiIter> access;
+        match_results<BidiIter> &what = *state.context_.results_ptr_;
         BOOST_ASSERT(0 != re.regex_id());
 
-        // the state object holds matching state and
-        // is passed by reference to all the matchers
-        detail::match_state<BidiIter> state(begin, end, what, *access::get_regex_impl(re), flags);
+        BidiIter const begin = state.begin_, end = state.end_;
         state.flags_.match_all_ = true;
-        state.sub_match(0).begin_ = begin;
+        state.sub_match(0).begin_.set(begin, begin);
 
         if(access::match(re, state))
         {
@@ -70,7 +72,7 @@ namespace detail
         }
 
         // handle partial matches
-        else if(state.found_partial_match_ && 0 != (flags & regex_constants::match_partial))
+        else if(state.found_partial_match_ && state.flags_.match_partial_)
         {
             state.set_partial_match();
             return true;
@@ -79,6 +81,27 @@ namespace detail
         access::reset(what);
         return false;
     }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // regex_match_impl
+    template<typename BidiIter>
+    inline bool regex_match_impl
+    (
+        BOOST_XPR_NONDEDUCED_TYPE_(BidiIter) begin
+      , BOOST_XPR_NONDEDUCED_TYPE_(BidiIter) end
+      , match_results<BidiIter> &what
+      , basic_regex<BidiIter> const &re
+      , regex_constants::match_flag_type flags = regex_constants::match_default
+    )
+    {
+        typedef detail::core_access<BidiIter> access;
+        BOOST_ASSERT(0 != re.regex_id());
+
+        // the state object holds matching state and
+        // is passed by reference to all the matchers
+        detail::match_state<BidiIter> state(begin, end, what, *access::get_regex_impl(re), flags);
+        return detail::regex_match_impl(state, re);
+    }
 } // namespace detail
 
 /// \brief See if a regex matches a sequence from beginning to end.
@@ -310,10 +333,10 @@ namespace detail
         save_restore<bool> not_null(state.flags_.match_not_null_, state.flags_.match_not_null_ || not_initial_null);
         state.flags_.match_prev_avail_ = state.flags_.match_prev_avail_ || !state.bos();
 
-        regex_impl<BidiIter> const &impl = *access::get_regex_impl(re);
+        regex_impl<BidiIter> const &impl = access::get_regex_impl_ref(re);
         BidiIter const begin = state.cur_, end = state.end_;
-        BidiIter &sub0begin = state.sub_match(0).begin_;
-        sub0begin = state.cur_;
+        sub_match_begin<BidiIter> &sub0begin = state.sub_match(0).begin_;
+        sub0begin.set(state.cur_, state.begin_);
 
         // If match_continuous is set, we only need to check for a match at the current position
         if(state.flags_.match_continuous_)
@@ -345,7 +368,7 @@ namespace detail
 
                 do
                 {
-                    sub0begin = state.cur_;
+                    sub0begin.set(state.cur_, state.begin_);
                     if(access::match(re, state))
                     {
                         access::set_prefix_suffix(what, begin, end);
@@ -359,7 +382,7 @@ namespace detail
                         return true;
                     }
 
-                    BOOST_ASSERT(state.cur_ == sub0begin);
+                    BOOST_ASSERT(state.cur_ == sub0begin.get(state.begin_));
                     not_null.restore();
                 }
                 while(state.cur_ != state.end_ && (++state.cur_, find(state)));
@@ -384,13 +407,13 @@ namespace detail
                     return true;
                 }
 
-                else if(end == sub0begin)
+                else if(end == sub0begin.get(state.begin_))
                 {
                     break;
                 }
 
-                BOOST_ASSERT(state.cur_ == sub0begin);
-                state.cur_ = ++sub0begin;
+                BOOST_ASSERT(state.cur_ == sub0begin.get(state.begin_));
+                sub0begin.set(++state.cur_, state.begin_);
                 not_null.restore();
             }
         }
@@ -654,6 +677,274 @@ inline bool regex_search
 
 namespace detail
 {
+    ///////////////////////////////////////////////////////////////////////////////
+    // literal_format
+    //   true if [begin, end) formats every match the same way, as itself
+    inline bool literal_format(char const *begin, char const *end, regex_constants::match_flag_type flags)
+    {
+        using namespace regex_constants;
+        if(0 != (flags & format_literal))
+        {
+            return true;
+        }
+
+        // the characters that are special in each dialect
+        char const *special =
+            0 != (flags & format_perl) ? "$\\" :
+            0 != (flags & format_sed) ? "&\\" :
+            0 != (flags & format_all) ? "$\\()?" : "$";
+        return end == std::find_first_of(begin, end, special, special + std::strlen(special));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // get_literal_format
+    //   if format is a string that formats every match the same way, sets
+    //   [begin, end) to it and returns true
+    inline bool get_literal_format(char const *format, char const *&begin, char const *&end, regex_constants::match_flag_type flags)
+    {
+        begin = format;
+        end = format + std::strlen(format);
+        return detail::literal_format(begin, end, flags);
+    }
+
+    template<typename Traits, typename Alloc>
+    inline bool get_literal_format
+    (
+        std::basic_string<char, Traits, Alloc> const &format
+      , char const *&begin
+      , char const *&end
+      , regex_constants::match_flag_type flags
+    )
+    {
+        begin = format.data();
+        end = begin + format.size();
+        return detail::literal_format(begin, end, flags);
+    }
+
+    template<typename Formatter>
+    inline bool get_literal_format(Formatter const &, char const *&, char const *&, regex_constants::match_flag_type)
+    {
+        return false;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // find_literal
+    //   like memmem, finds the first [lit, lit + size) in [cur, end), or returns null
+    inline char const *find_literal(char const *cur, char const *end, char const *lit, std::size_t size)
+    {
+        BOOST_ASSERT(0 != size);
+        for(; static_cast<std::size_t>(end - cur) >= size; ++cur)
+        {
+            cur = static_cast<char const *>(std::memchr(cur, *lit, static_cast<std::size_t>(end - cur) - size + 1));
+            if(0 == cur)
+            {
+                return 0;
+            }
+            else if(0 == std::memcmp(cur + 1, lit + 1, size - 1))
+            {
+                return cur;
+            }
+        }
+        return 0;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // use_literal_replace
+    //   When a regex is nothing but a string, regex_impl::literal_ holds it. Then
+    //   if the format is a string that doesn't depend on the match, replacing
+    //   needs no match_state: the string is found with memchr and memcmp and the
+    //   format is copied. Only regexes over contiguous chars have a literal_.
+    template<typename BidiIter>
+    struct use_literal_replace
+      : mpl::and_<
+            is_contiguous<BidiIter>
+          , is_same<typename iterator_value<BidiIter>::type, char>
+        >
+    {
+    };
+
+    template<typename BidiIter, typename Formatter>
+    inline bool can_literal_replace
+    (
+        regex_impl<BidiIter> const &impl
+      , Formatter const &format
+      , char const *&fmt_begin
+      , char const *&fmt_end
+      , regex_constants::match_flag_type flags
+    )
+    {
+        using namespace regex_constants;
+        return !impl.literal_.empty()
+            && 0 == (flags & (match_continuous | match_partial))
+            && detail::get_literal_format(format, fmt_begin, fmt_end, flags);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // literal_replace
+    //   returns false if the replacement can't be done this way
+    template<typename OutIter, typename BidiIter, typename Formatter>
+    inline bool literal_replace
+    (
+        OutIter &out
+      , BidiIter begin
+      , BidiIter end
+      , regex_impl<BidiIter> const &impl
+      , Formatter const &format
+      , regex_constants::match_flag_type flags
+      , mpl::true_
+    )
+    {
+        using namespace regex_constants;
+        char const *fmt_begin = 0, *fmt_end = 0;
+        if(!detail::can_literal_replace(impl, format, fmt_begin, fmt_end, flags))
+        {
+            return false;
+        }
+        else if(begin == end)
+        {
+            return true;
+        }
+
+        bool const yes_copy = (0 == (flags & format_no_copy));
+        char const *cur = &*begin, *const last = cur + (end - begin);
+        char const *const lit = impl.literal_.data();
+        std::size_t const size = impl.literal_.size();
+
+        for(char const *found = 0; 0 != (found = detail::find_literal(cur, last, lit, size));)
+        {
+            if(yes_copy)
+            {
+                out = std::copy(cur, found, out);
+            }
+
+            out = std::copy(fmt_begin, fmt_end, out);
+            cur = found + size;
+
+            if(0 != (flags & format_first_only))
+            {
+                break;
+            }
+        }
+
+        if(yes_copy)
+        {
+            out = std::copy(cur, last, out);
+        }
+
+        return true;
+    }
+
+    template<typename OutIter, typename BidiIter, typename Formatter>
+    inline bool literal_replace
+    (
+        OutIter &
+      , BidiIter
+      , BidiIter
+      , regex_impl<BidiIter> const &
+      , Formatter const &
+      , regex_constants::match_flag_type
+      , mpl::false_
+    )
+    {
+        return false;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // literal_replace_string
+    //   like literal_replace, but counts the replacements first so the string
+    //   can be presized, and appends to it directly
+    template<typename Traits, typename Alloc, typename BidiIter, typename Formatter>
+    inline bool literal_replace_string_
+    (
+        std::basic_string<char, Traits, Alloc> &result
+      , BidiIter begin
+      , BidiIter end
+      , regex_impl<BidiIter> const &impl
+      , Formatter const &format
+      , regex_constants::match_flag_type flags
+      , mpl::true_
+    )
+    {
+        using namespace regex_constants;
+        char const *fmt_begin = 0, *fmt_end = 0;
+        if(!detail::can_literal_replace(impl, format, fmt_begin, fmt_end, flags))
+        {
+            return false;
+        }
+        else if(begin == end)
+        {
+            return true;
+        }
+
+        bool const yes_copy = (0 == (flags & format_no_copy));
+        bool const first_only = (0 != (flags & format_first_only));
+        char const *const first = &*begin, *const last = first + (end - begin);
+        char const *const lit = impl.literal_.data();
+        std::size_t const size = impl.literal_.size();
+        char const *cur = first, *found = 0;
+
+        std::size_t count = 0;
+        for(; 0 != (found = detail::find_literal(cur, last, lit, size)); cur = found + size)
+        {
+            ++count;
+            if(first_only)
+            {
+                break;
+            }
+        }
+
+        std::size_t const copied = yes_copy ? static_cast<std::size_t>(last - first) - count * size : 0;
+        result.reserve(result.size() + copied + count * static_cast<std::size_t>(fmt_end - fmt_begin));
+
+        cur = first;
+        for(; 0 != count && 0 != (found = detail::find_literal(cur, last, lit, size)); cur = found + size, --count)
+        {
+            if(yes_copy)
+            {
+                result.append(cur, found);
+            }
+
+            result.append(fmt_begin, fmt_end);
+        }
+
+        if(yes_copy)
+        {
+            result.append(cur, last);
+        }
+
+        return true;
+    }
+
+    template<typename BidiContainer, typename BidiIter, typename Formatter, typename UseLiteral>
+    inline bool literal_replace_string_
+    (
+        BidiContainer &
+      , BidiIter
+      , BidiIter
+      , regex_impl<BidiIter> const &
+      , Formatter const &
+      , regex_constants::match_flag_type
+      , UseLiteral
+    )
+    {
+        return false;
+    }
+
+    template<typename BidiContainer, typename BidiIter, typename Formatter>
+    inline bool literal_replace_string
+    (
+        BidiContainer &result
+      , BidiIter begin
+      , BidiIter end
+      , basic_regex<BidiIter> const &re
+      , Formatter const &format
+      , regex_constants::match_flag_type flags
+    )
+    {
+        regex_impl<BidiIter> const &impl = *core_access<BidiIter>::get_regex_impl(re);
+        return detail::literal_replace_string_(result, begin, end, impl, format, flags, typename use_literal_replace<BidiIter>::type());
+    }
+
     ///////////////////////////////////////////////////////////////////////////////
     // regex_replace_impl
     template<typename OutIter, typename BidiIter, typename Formatter>
@@ -671,6 +962,11 @@ namespace detail
         typedef detail::core_access<BidiIter> access;
         BOOST_ASSERT(0 != re.regex_id());
 
+        if(detail::literal_replace(out, begin, end, *access::get_regex_impl(re), format, flags, typename use_literal_replace<BidiIter>::type()))
+        {
+            return out;
+        }
+
         BidiIter cur = begin;
         match_results<BidiIter> what;
         detail::match_state<BidiIter> state(begin, end, what, *access::get_regex_impl(re), flags);
@@ -827,7 +1123,11 @@ inline BidiContainer regex_replace
         return result;
     }
 
-    detail::regex_replace_impl(std::back_inserter(result), begin, end, re, format, flags);
+    if(!detail::literal_replace_string(result, begin, end, re, format, flags))
+    {
+        detail::regex_replace_impl(std::back_inserter(result), begin, end, re, format, flags);
+    }
+
     return result;
 }
 
@@ -859,7 +1159,11 @@ inline BidiContainer regex_replace
         return result;
     }
 
-    detail::regex_replace_impl(std::back_inserter(result), begin, end, re, format, flags);
+    if(!detail::literal_replace_string(result, begin, end, re, format, flags))
+    {
+        detail::regex_replace_impl(std::back_inserter(result), begin, end, re, format, flags);
+    }
+
     return result;
 }
 
@@ -890,7 +1194,11 @@ inline std::basic_string<typename remove_const<Char>::type> regex_replace
     }
 
     Char *end = str + std::char_traits<char_type>::length(str);
-    detail::regex_replace_impl(std::back_inserter(result), str, end, re, format, flags);
+    if(!detail::literal_replace_string(result, str, end, re, format, flags))
+    {
+        detail::regex_replace_impl(std::back_inserter(result), str, end, re, format, flags);
+    }
+
     return result;
 }
 
@@ -922,7 +1230,11 @@ inline BidiContainer regex_replace
         return result;
     }
 
-    detail::regex_replace_impl(std::back_inserter(result), begin, end, re, format, flags);
+    if(!detail::literal_replace_string(result, begin, end, re, format, flags))
+    {
+        detail::regex_replace_impl(std::back_inserter(result), begin, end, re, format, flags);
+    }
+
     return result;
 }
 
@@ -954,7 +1266,11 @@ inline BidiContainer regex_replace
         return result;
     }
 
-    detail::regex_replace_impl(std::back_inserter(result), begin, end, re, format, flags);
+    if(!detail::literal_replace_string(result, begin, end, re, format, flags))
+    {
+        detail::regex_replace_impl(std::back_inserter(result), begin, end, re, format, flags);
+    }
+
     return result;
 }
 
@@ -984,7 +1300,11 @@ inline std::basic_string<typename remove_const<Char>::type> regex_replace
     }
 
     Char *end = str + std::char_traits<char_type>::length(str);
-    detail::regex_replace_impl(std::back_inserter(result), str, end, re, format, flags);
+    if(!detail::literal_replace_string(result, str, end, re, format, flags))
+    {
+        detail::regex_replace_impl(std::back_inserter(result), str, end, re, format, flags);
+    }
+
     return result;
 }
 
@@ -16,6 +16,7 @@
 #endif
 
 #include <map>
+#include <vector>
 #include <boost/config.hpp>
 #include <boost/assert.hpp>
 #include <boost/next_prior.hpp>
@@ -209,6 +210,21 @@ private:
 
         this->self_ = detail::core_access<BidiIter>::get_regex_impl(*prex);
 
+        // the named marks of an earlier compile may be shared with match_results objects
+        this->self_->named_marks_.reset();
+
+        // remember if the whole regex is a case-sensitive string
+        string_type literal;
+        tmp = begin;
+        if(0 == (this->traits_.flags() & icase_) && token_literal == this->traits_.get_token(tmp, end))
+        {
+            literal = this->parse_literal(tmp, end);
+            if(tmp != end)
+            {
+                literal.clear();
+            }
+        }
+
         // at the top level, a regex is a sequence of alternates
         detail::sequence<BidiIter> seq = this->parse_alternates(begin, end);
         BOOST_XPR_ENSURE_(begin == end, error_paren, "mismatched parenthesis");
@@ -218,6 +234,10 @@ private:
 
         // bundle the regex information into a regex_impl object
         detail::common_compile(seq.xpr().matchable(), *this->self_, this->rxtraits());
+        if(!literal.empty())
+        {
+            detail::optimize_literal(*this->self_, literal, this->rxtraits());
+        }
 
         this->self_->traits_ = new detail::traits_holder<RegexTraits>(this->rxtraits());
         this->self_->mark_count_ = this->mark_count_;
@@ -275,21 +295,100 @@ private:
         int count = 0;
         FwdIter tmp = begin;
         detail::sequence<BidiIter> seq;
+        std::vector<string_type> literals; // alternates that are nothing but a literal
+
+        do
+        {
+            string_type literal;
+            if(this->parse_literal_alternate(tmp, end, literal))
+            {
+                literals.push_back(literal);
+            }
+            else
+            {
+                this->add_literal_alternates(seq, count, literals);
+                this->add_alternate(seq, count, this->parse_sequence(tmp, end));
+            }
+        }
+        while((begin = tmp) != end && token_alternate == this->traits_.get_token(tmp, end));
+
+        this->add_literal_alternates(seq, count, literals);
+        return seq;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // parse_literal_alternate
+    //  if the next alternate is nothing but a literal, parse it
+    /// INTERNAL ONLY
+    template<typename FwdIter>
+    bool parse_literal_alternate(FwdIter &begin, FwdIter end, string_type &literal)
+    {
+        using namespace regex_constants;
+        FwdIter tmp = begin;
+        if(tmp == end || token_literal != this->traits_.get_token(tmp, end))
+        {
+            return false;
+        }
+
+        string_type str = this->parse_literal(tmp, end);
+        FwdIter next = tmp;
+        switch(next == end ? token_end_of_pattern : this->traits_.get_token(next, end))
+        {
+        case token_alternate:
+        case token_group_end:
+        case token_end_of_pattern:
+            literal.swap(str);
+            begin = tmp;
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // add_literal_alternates
+    //  enough literals in a row are matched with one trie, instead of one
+    //  after the other. Either way, the first literal that matches wins.
+    /// INTERNAL ONLY
+    void add_literal_alternates(detail::sequence<BidiIter> &seq, int &count, std::vector<string_type> &literals)
+    {
+        if(literals.size() >= 16)
+        {
+            this->add_alternate
+            (
+                seq
+              , count
+              , detail::make_trie_xpression<BidiIter>(literals, this->traits_.flags(), this->rxtraits())
+            );
+        }
+        else for(std::size_t i = 0; i < literals.size(); ++i)
+        {
+            this->add_alternate
+            (
+                seq
+              , count
+              , detail::make_literal_xpression<BidiIter>(literals[i], this->traits_.flags(), this->rxtraits())
+            );
+        }
+        literals.clear();
+    }
 
-        do switch(++count)
+    ///////////////////////////////////////////////////////////////////////////
+    // add_alternate
+    /// INTERNAL ONLY
+    void add_alternate(detail::sequence<BidiIter> &seq, int &count, detail::sequence<BidiIter> const &alt)
+    {
+        switch(++count)
         {
         case 1:
-            seq = this->parse_sequence(tmp, end);
+            seq = alt;
             break;
         case 2:
             seq = detail::make_dynamic<BidiIter>(alternate_matcher()) | seq;
             BOOST_FALLTHROUGH;
         default:
-            seq |= this->parse_sequence(tmp, end);
+            seq |= alt;
         }
-        while((begin = tmp) != end && token_alternate == this->traits_.get_token(tmp, end));
-
-        return seq;
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -366,7 +465,7 @@ private:
               , error_paren
               , "mismatched parenthesis"
             );
-            return detail::make_dynamic<BidiIter>(detail::regex_byref_matcher<BidiIter>(this->self_));
+            return detail::make_dynamic<BidiIter>(detail::regex_byref_matcher<BidiIter>(this->self_, this->nosubs_()));
 
         case token_rule_assign:
             BOOST_THROW_EXCEPTION(
@@ -386,16 +485,21 @@ private:
                 basic_regex<BidiIter> &rex = this->rules_[name];
                 shared_ptr<detail::regex_impl<BidiIter> > impl = access::get_regex_impl(rex);
                 this->self_->track_reference(*impl);
-                return detail::make_dynamic<BidiIter>(detail::regex_byref_matcher<BidiIter>(impl));
+                return detail::make_dynamic<BidiIter>(detail::regex_byref_matcher<BidiIter>(impl, this->nosubs_()));
             }
 
         case token_named_mark:
             mark_nbr = static_cast<int>(++this->mark_count_);
-            for(std::size_t i = 0; i < this->self_->named_marks_.size(); ++i)
+            if(!this->self_->named_marks_)
             {
-                BOOST_XPR_ENSURE_(this->self_->named_marks_[i].name_ != name, error_badmark, "named mark already exists");
+                this->self_->named_marks_ = new detail::named_marks<char_type>;
             }
-            this->self_->named_marks_.push_back(detail::named_mark<char_type>(name, this->mark_count_));
+            BOOST_XPR_ENSURE_
+            (
+                this->self_->named_marks_->insert(name, this->mark_count_)
+              , error_badmark
+              , "named mark already exists"
+            );
             seq = detail::make_dynamic<BidiIter>(detail::mark_begin_matcher(mark_nbr));
             seq_end = detail::make_dynamic<BidiIter>(detail::mark_end_matcher(mark_nbr));
             break;
@@ -407,11 +511,11 @@ private:
               , error_paren
               , "mismatched parenthesis"
             );
-            for(std::size_t i = 0; i < this->self_->named_marks_.size(); ++i)
+            if(this->self_->named_marks_)
             {
-                if(this->self_->named_marks_[i].name_ == name)
+                if(detail::named_mark<char_type> const *mark = this->self_->named_marks_->find(name.begin(), name.end()))
                 {
-                    mark_nbr = static_cast<int>(this->self_->named_marks_[i].mark_nbr_);
+                    mark_nbr = static_cast<int>(mark->mark_nbr_);
                     return detail::make_backref_xpression<BidiIter>
                     (
                         mark_nbr, this->traits_.flags(), this->rxtraits()
@@ -746,6 +850,12 @@ private:
         return 0 != this->upper_ && this->rxtraits().isctype(ch, this->upper_);
     }
 
+    // whether nested regexes should be invoked without creating nested results
+    bool nosubs_() const
+    {
+        return 0 != (this->traits_.flags() & regex_constants::nosubs_);
+    }
+
     std::size_t mark_count_;
     std::size_t hidden_mark_count_;
     CompilerTraits traits_;
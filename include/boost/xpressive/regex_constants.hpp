@@ -19,6 +19,7 @@
 
 #ifndef BOOST_XPRESSIVE_DOXYGEN_INVOKED
 # define icase icase_
+# define nosubs nosubs_
 #endif
 
 namespace boost { namespace xpressive { namespace regex_constants
@@ -142,6 +143,10 @@ enum match_flag_type
                                         ///< and match_not_bow are ignored by the regular expression
                                         ///< algorithms (RE.7) and iterators (RE.8).
                                         ///<
+    match_memoize           = 1 << 19,  ///< Specifies that a nested regex that fails to match at a
+                                        ///< position should not be tried there again. Only has an
+                                        ///< effect with random-access iterators.
+                                        ///<
     format_default          = 0,        ///< Specifies that when a regular expression match is to be
                                         ///< replaced by a new string, that the new string is
                                         ///< constructed using the rules used by the ECMAScript
@@ -289,6 +294,7 @@ inline match_flag_type operator ~(match_flag_type b)
 
 #ifndef BOOST_XPRESSIVE_DOXYGEN_INVOKED
 # undef icase
+# undef nosubs
 #endif
 
 #endif
@@ -0,0 +1,140 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file regex_context.hpp
+/// Contains the definition of the regex_context type, a reusable handle for
+/// repeatedly matching or searching with the same regex.
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_XPRESSIVE_REGEX_CONTEXT_HPP_EAN_10_04_2005
+#define BOOST_XPRESSIVE_REGEX_CONTEXT_HPP_EAN_10_04_2005
+
+// MS compatible compilers support #pragma once
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+#include <boost/noncopyable.hpp>
+#include <boost/xpressive/basic_regex.hpp>
+#include <boost/xpressive/match_results.hpp>
+#include <boost/xpressive/regex_algorithms.hpp>
+#include <boost/xpressive/detail/detail_fwd.hpp>
+#include <boost/xpressive/detail/core/access.hpp>
+#include <boost/xpressive/detail/core/state.hpp>
+
+namespace boost { namespace xpressive
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// regex_context
+//
+/// \brief Class template regex_context\<\> binds a regex to the matching state
+/// and the match_results needed to run it, so they can be reused across calls.
+///
+/// Each call to regex_match() or regex_search() sets up a fresh matching state
+/// for the match_results object it is given. A regex_context\<\> owns both, and
+/// only re-targets them at the new input sequence on each call to search() or
+/// match(). Once the internal buffers have grown to fit the regex, repeated
+/// calls do not allocate.
+///
+/// A regex_context\<\> holds its own copy of the regex. It is not thread-safe;
+/// use one context per thread.
+template<typename BidiIter>
+struct regex_context
+  : private noncopyable
+{
+    typedef basic_regex<BidiIter> regex_type;
+    typedef match_results<BidiIter> results_type;
+
+    /// \param rex The regex to match with.
+    /// \param flags Optional match flags, used to control how the expression is matched
+    ///        against the sequence. (See \c match_flag_type.)
+    /// \post regex().regex_id() == rex.regex_id()
+    /// \post results().empty() == true
+    explicit regex_context
+    (
+        basic_regex<BidiIter> const &rex
+      , regex_constants::match_flag_type flags = regex_constants::match_default
+    )
+      : rex_(rex)
+      , impl_(access::get_regex_impl(rex_).get())
+      , flags_(flags)
+      , what_()
+      , state_(BidiIter(), BidiIter(), what_, *impl_, flags)
+    {
+    }
+
+    /// Determines whether there is some sub-sequence within <tt>[begin,end)</tt> that matches
+    /// the regex. Equivalent to <tt>regex_search(begin, end, results(), regex(), flags)</tt>.
+    ///
+    /// \pre <tt>[begin,end)</tt> denotes a valid iterator range.
+    /// \return \c true if a match is found, \c false otherwise
+    /// \throw regex_error on stack exhaustion
+    bool search(BidiIter begin, BidiIter end)
+    {
+        // a default-constructed regex matches nothing
+        if(0 == this->rex_.regex_id())
+        {
+            access::reset(this->what_);
+            return false;
+        }
+
+        this->state_.restart(begin, end, this->what_, *this->impl_, this->flags_);
+        return detail::regex_search_impl(this->state_, this->rex_);
+    }
+
+    /// Determines whether the regex matches all of <tt>[begin,end)</tt>.
+    /// Equivalent to <tt>regex_match(begin, end, results(), regex(), flags)</tt>.
+    ///
+    /// \pre <tt>[begin,end)</tt> denotes a valid iterator range.
+    /// \return \c true if a match is found, \c false otherwise
+    /// \throw regex_error on stack exhaustion
+    bool match(BidiIter begin, BidiIter end)
+    {
+        // a default-constructed regex matches nothing
+        if(0 == this->rex_.regex_id())
+        {
+            access::reset(this->what_);
+            return false;
+        }
+
+        this->state_.restart(begin, end, this->what_, *this->impl_, this->flags_);
+        return detail::regex_match_impl(this->state_, this->rex_);
+    }
+
+    /// Returns the results of the most recent call to search() or match(). They
+    /// remain valid until the next call.
+    results_type const &results() const
+    {
+        return this->what_;
+    }
+
+    /// Returns the regex this context matches with.
+    ///
+    regex_type const &regex() const
+    {
+        return this->rex_;
+    }
+
+    /// Returns the match flags this context was constructed with.
+    ///
+    regex_constants::match_flag_type flags() const
+    {
+        return this->flags_;
+    }
+
+private:
+    /// INTERNAL ONLY
+    typedef detail::core_access<BidiIter> access;
+
+    regex_type rex_;
+    detail::regex_impl<BidiIter> const *impl_;
+    regex_constants::match_flag_type flags_;
+    results_type what_;
+    detail::match_state<BidiIter> state_;
+};
+
+}} // namespace boost::xpressive
+
+#endif
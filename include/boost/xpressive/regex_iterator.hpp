@@ -15,6 +15,7 @@
 # pragma once
 #endif
 
+#include <boost/ref.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/intrusive_ptr.hpp>
 #include <boost/iterator/iterator_traits.hpp>
@@ -27,7 +28,8 @@ namespace boost { namespace xpressive { namespace detail
 
 //////////////////////////////////////////////////////////////////////////
 // regex_iterator_impl
-//
+//   If borrowed is true, the regex is used in place and must outlive the
+//   iterator; otherwise, the iterator keeps its own copy.
 template<typename BidiIter>
 struct regex_iterator_impl
   : counted_base<regex_iterator_impl<BidiIter> >
@@ -43,21 +45,28 @@ struct regex_iterator_impl
       , basic_regex<BidiIter> const &rex
       , regex_constants::match_flag_type flags
       , bool not_null = false
+      , bool borrowed = false
     )
-      : rex_(rex)
+      : rex_()
+      , prex_(&rex)
       , what_()
-      , state_(begin, end, what_, *access::get_regex_impl(rex_), flags)
+      , state_(begin, end, what_, access::get_regex_impl_ref(rex), flags)
       , flags_(flags)
       , not_null_(not_null)
     {
+        if(!borrowed)
+        {
+            this->rex_ = rex;
+            this->prex_ = &this->rex_;
+        }
         this->state_.cur_ = cur;
         this->state_.next_search_ = next_search;
     }
 
     bool next()
     {
-        this->state_.reset(this->what_, *access::get_regex_impl(this->rex_));
-        if(!regex_search_impl(this->state_, this->rex_, this->not_null_))
+        this->state_.reset(this->what_, access::get_regex_impl_ref(*this->prex_));
+        if(!regex_search_impl(this->state_, *this->prex_, this->not_null_))
         {
             return false;
         }
@@ -73,7 +82,7 @@ struct regex_iterator_impl
 
     bool equal_to(regex_iterator_impl<BidiIter> const &that) const
     {
-        return this->rex_.regex_id()    == that.rex_.regex_id()
+        return this->prex_->regex_id()  == that.prex_->regex_id()
             && this->state_.begin_      == that.state_.begin_
             && this->state_.cur_        == that.state_.cur_
             && this->state_.end_        == that.state_.end_
@@ -81,7 +90,13 @@ struct regex_iterator_impl
             ;
     }
 
+    bool borrowed() const
+    {
+        return this->prex_ != &this->rex_;
+    }
+
     basic_regex<BidiIter> rex_;
+    basic_regex<BidiIter> const *prex_;
     match_results<BidiIter> what_;
     match_state<BidiIter> state_;
     regex_constants::match_flag_type const flags_;
@@ -127,6 +142,26 @@ struct regex_iterator
         }
     }
 
+    /// Iterates with rex in place rather than with a copy of it. The regex must
+    /// outlive the iterator and all copies of it, and must not be modified while
+    /// they are in use. Since a borrowed regex is only ever read, many threads
+    /// can iterate with the same regex without contending for its reference count.
+    regex_iterator
+    (
+        BidiIter begin
+      , BidiIter end
+      , reference_wrapper<basic_regex<BidiIter> const> rex
+      , regex_constants::match_flag_type flags = regex_constants::match_default
+    )
+      : impl_()
+    {
+        if(0 != rex.get().regex_id()) // Empty regexes are guaranteed to match nothing
+        {
+          this->impl_ = new impl_type_(begin, begin, end, begin, rex.get(), flags, false, true);
+          this->next_();
+        }
+    }
+
     template<typename LetExpr>
     regex_iterator
     (
@@ -157,6 +192,24 @@ struct regex_iterator
         return *this;
     }
 
+    #ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+    // Unlike a copy, a moved iterator doesn't share its state, so
+    // incrementing it needn't fork.
+    regex_iterator(regex_iterator<BidiIter> &&that) BOOST_NOEXCEPT
+      : impl_()
+    {
+        this->impl_.swap(that.impl_);
+    }
+
+    regex_iterator<BidiIter> &operator =(regex_iterator<BidiIter> &&that) BOOST_NOEXCEPT
+    {
+        intrusive_ptr<impl_type_> impl;
+        impl.swap(that.impl_);
+        this->impl_.swap(impl);
+        return *this;
+    }
+    #endif
+
     friend bool operator ==(regex_iterator<BidiIter> const &left, regex_iterator<BidiIter> const &right)
     {
         if(!left.impl_ || !right.impl_)
@@ -233,9 +286,10 @@ private:
               , that->state_.cur_
               , that->state_.end_
               , that->state_.next_search_
-              , that->rex_
+              , *that->prex_
               , that->flags_
               , that->not_null_
+              , that->borrowed()
             );
             detail::core_access<BidiIter>::get_action_args(this->impl_->what_)
                 = detail::core_access<BidiIter>::get_action_args(that->what_);
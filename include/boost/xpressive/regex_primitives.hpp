@@ -29,6 +29,7 @@
 # include <boost/proto/transform/arg.hpp>
 # include <boost/proto/transform/when.hpp>
 # include <boost/xpressive/detail/core/icase.hpp>
+# include <boost/xpressive/detail/core/nosubs.hpp>
 # include <boost/xpressive/detail/static/compile.hpp>
 # include <boost/xpressive/detail/static/modifier.hpp>
 #endif
@@ -617,6 +618,19 @@ BOOST_XPRESSIVE_GLOBAL_MARK_TAG(s9, 9);
 template<typename Expr> detail::unspecified icase(Expr const &expr) { return 0; }
 #endif
 
+// NOTE: Like icase(), nosubs() is really a function object defined in detail/nosubs.hpp
+// so that it can serve double-duty as regex_constants::nosubs, the syntax_option_type.
+#ifdef BOOST_XPRESSIVE_DOXYGEN_INVOKED
+///////////////////////////////////////////////////////////////////////////////
+/// \brief Keeps nested regexes from creating nested results.
+///
+/// Use nosubs() around a sub-expression that invokes other regexes, when the
+/// results of those invocations are not needed. For instance, in
+/// word >> *(' ' >> nosubs(word)), only the first word is added to the nested
+/// results. Nested regexes invoked this way are cheaper to match.
+template<typename Expr> detail::unspecified nosubs(Expr const &expr) { return 0; }
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief Makes a literal into a regular expression.
 ///
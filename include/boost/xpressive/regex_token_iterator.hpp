@@ -45,11 +45,13 @@ struct regex_token_iterator_impl
       , std::vector<int> subs = std::vector<int>(1, 0)
       , int n = -2
       , bool not_null = false
+      , bool borrowed = false
     )
-      : iter_(begin, cur, end, next_search, rex, flags, not_null)
+      : iter_(begin, cur, end, next_search, rex, flags, not_null, borrowed)
       , result_()
       , n_((-2 == n) ? (int)subs.size() - 1 : n)
       , subs_()
+      , tokens_(subs.size())
     {
         BOOST_ASSERT(0 != subs.size());
         this->subs_.swap(subs);
@@ -60,11 +62,9 @@ struct regex_token_iterator_impl
         if(-1 != this->n_)
         {
             BidiIter cur = this->iter_.state_.cur_;
-            if(0 != (++this->n_ %= (int)this->subs_.size()) || this->iter_.next())
+            if(0 != (++this->n_ %= (int)this->subs_.size()) || this->next_match_())
             {
-                this->result_ = (-1 == this->subs_[ this->n_ ])
-                    ? this->iter_.what_.prefix()
-                    : this->iter_.what_[ this->subs_[ this->n_ ] ];
+                this->result_ = this->tokens_[ this->n_ ];
                 return true;
             }
             else if(-1 == this->subs_[ this->n_-- ] && cur != this->iter_.state_.end_)
@@ -82,10 +82,29 @@ struct regex_token_iterator_impl
         return this->iter_.equal_to(that.iter_) && this->n_ == that.n_;
     }
 
+    // Finds the next match and saves all the tokens it yields, so that
+    // a copy of this iterator can yield them without the match_results.
+    bool next_match_()
+    {
+        if(!this->iter_.next())
+        {
+            return false;
+        }
+
+        for(std::size_t i = 0; i < this->subs_.size(); ++i)
+        {
+            this->tokens_[ i ] = (-1 == this->subs_[ i ])
+                ? this->iter_.what_.prefix()
+                : this->iter_.what_[ this->subs_[ i ] ];
+        }
+        return true;
+    }
+
     regex_iterator_impl<BidiIter> iter_;
     value_type result_;
     int n_;
     std::vector<int> subs_;
+    std::vector<value_type> tokens_;
 };
 
 inline int get_mark_number(int i)
@@ -168,6 +187,57 @@ struct regex_token_iterator
         }
     }
 
+    /// \param begin The beginning of the character range to search.
+    /// \param end The end of the character range to search.
+    /// \param rex The regex pattern to search for. It is used in place rather than
+    ///     copied, so it must outlive the iterator and all copies of it, and must
+    ///     not be modified while they are in use.
+    /// \param flags Optional match flags, used to control how the expression is matched against the sequence. (See match_flag_type.)
+    /// \pre \c [begin,end) is a valid range.
+    regex_token_iterator
+    (
+        BidiIter begin
+      , BidiIter end
+      , reference_wrapper<basic_regex<BidiIter> const> rex
+      , regex_constants::match_flag_type flags = regex_constants::match_default
+    )
+      : impl_()
+    {
+        if(0 != rex.get().regex_id())
+        {
+            this->impl_ = new impl_type_(begin, begin, end, begin, rex.get(), flags, std::vector<int>(1, 0), -2, false, true);
+            this->next_();
+        }
+    }
+
+    /// \param begin The beginning of the character range to search.
+    /// \param end The end of the character range to search.
+    /// \param rex The regex pattern to search for. It is used in place rather than
+    ///     copied, so it must outlive the iterator and all copies of it, and must
+    ///     not be modified while they are in use.
+    /// \param subs A range of integers designating sub-matches to be treated as tokens.
+    /// \param flags Optional match flags, used to control how the expression is matched against the sequence. (See match_flag_type.)
+    /// \pre \c [begin,end) is a valid range.
+    /// \pre \c subs is either an integer greater or equal to -1,
+    ///     or else an array or non-empty \c std::vector\<\> of such integers.
+    template<typename Subs>
+    regex_token_iterator
+    (
+        BidiIter begin
+      , BidiIter end
+      , reference_wrapper<basic_regex<BidiIter> const> rex
+      , Subs const &subs
+      , regex_constants::match_flag_type flags = regex_constants::match_default
+    )
+      : impl_()
+    {
+        if(0 != rex.get().regex_id())
+        {
+            this->impl_ = new impl_type_(begin, begin, end, begin, rex.get(), flags, detail::to_vector(subs), -2, false, true);
+            this->next_();
+        }
+    }
+
     /// \param begin The beginning of the character range to search.
     /// \param end The end of the character range to search.
     /// \param rex The regex pattern to search for.
@@ -259,6 +329,26 @@ struct regex_token_iterator
         return *this;
     }
 
+    #ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+    /// \post <tt>*this</tt> is equal to the old value of \c that
+    /// \post <tt>that == regex_token_iterator()</tt>
+    regex_token_iterator(regex_token_iterator<BidiIter> &&that) BOOST_NOEXCEPT
+      : impl_()
+    {
+        this->impl_.swap(that.impl_);
+    }
+
+    /// \post <tt>*this</tt> is equal to the old value of \c that
+    /// \post <tt>that == regex_token_iterator()</tt>
+    regex_token_iterator<BidiIter> &operator =(regex_token_iterator<BidiIter> &&that) BOOST_NOEXCEPT
+    {
+        intrusive_ptr<impl_type_> impl;
+        impl.swap(that.impl_);
+        this->impl_.swap(impl);
+        return *this;
+    }
+    #endif
+
     friend bool operator ==(regex_token_iterator<BidiIter> const &left, regex_token_iterator<BidiIter> const &right)
     {
         if(!left.impl_ || !right.impl_)
@@ -327,29 +417,26 @@ private:
               , this->impl_->iter_.state_.cur_
               , this->impl_->iter_.state_.end_
               , this->impl_->iter_.state_.next_search_
-              , this->impl_->iter_.rex_
+              , *this->impl_->iter_.prex_
               , this->impl_->iter_.flags_
               , this->impl_->subs_
               , this->impl_->n_
               , this->impl_->iter_.not_null_
+              , this->impl_->iter_.borrowed()
             );
 
-            // only copy the match_results struct if we have to. Note: if the next call
-            // to impl_->next() will return false or call regex_search, we don't need to
-            // copy the match_results struct.
+            // The tokens of the current match are saved apart from the match_results,
+            // so the clone needs only those. Note: if the next call to impl_->next()
+            // will return false or call regex_search, we don't even need those.
             if(-1 != this->impl_->n_ && this->impl_->n_ + 1 != static_cast<int>(this->impl_->subs_.size()))
             {
-                // BUGBUG This is expensive -- it causes the sequence_stack to be cleared.
-                // Find a better way
-                clone->iter_.what_ = this->impl_->iter_.what_;
-            }
-            else
-            {
-                // At the very least, copy the action args
-                detail::core_access<BidiIter>::get_action_args(clone->iter_.what_)
-                    = detail::core_access<BidiIter>::get_action_args(this->impl_->iter_.what_);
+                clone->tokens_ = this->impl_->tokens_;
             }
 
+            // copy the action args
+            detail::core_access<BidiIter>::get_action_args(clone->iter_.what_)
+                = detail::core_access<BidiIter>::get_action_args(this->impl_->iter_.what_);
+
             this->impl_.swap(clone);
         }
     }
@@ -20,12 +20,18 @@
 #include <utility>
 #include <iterator>
 #include <algorithm>
+#include <boost/config.hpp>
 #include <boost/mpl/assert.hpp>
 #include <boost/type_traits/is_same.hpp>
 #include <boost/iterator/iterator_traits.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/range/const_iterator.hpp>
 #include <boost/range/mutable_iterator.hpp>
 #include <boost/xpressive/detail/detail_fwd.hpp>
+#include <boost/xpressive/detail/static/type_traits.hpp>
+#ifndef BOOST_NO_CXX17_HDR_STRING_VIEW
+# include <string_view>
+#endif
 
 //{{AFX_DOC_COMMENT
 ///////////////////////////////////////////////////////////////////////////////
@@ -74,6 +80,9 @@ public:
     typedef typename iterator_difference<BidiIter>::type difference_type;
     typedef typename detail::string_type<value_type>::type string_type;
     typedef BidiIter iterator;
+#ifndef BOOST_NO_CXX17_HDR_STRING_VIEW
+    typedef std::basic_string_view<value_type> string_view_type;
+#endif
 
     sub_match()
       : std::pair<BidiIter, BidiIter>()
@@ -97,6 +106,23 @@ public:
         return this->matched ? string_type(this->first, this->second) : string_type();
     }
 
+#ifndef BOOST_NO_CXX17_HDR_STRING_VIEW
+    /// \brief A view of the matched characters, without copying them.
+    /// \pre \c BidiIter is a contiguous iterator, such as a pointer or a \c std::string iterator.
+    /// \return a \c basic_string_view of <tt>[first,second)</tt> if \c matched, otherwise an empty one.
+    string_view_type view() const
+    {
+        BOOST_MPL_ASSERT_MSG(
+            detail::is_contiguous<BidiIter>::value
+          , VIEW_REQUIRES_A_CONTIGUOUS_ITERATOR
+          , (BidiIter)
+        );
+        return this->matched && this->first != this->second
+          ? string_view_type(&*this->first, static_cast<std::size_t>(this->second - this->first))
+          : string_view_type();
+    }
+#endif
+
     difference_type length() const
     {
         return this->matched ? std::distance(this->first, this->second) : 0;
@@ -117,25 +143,55 @@ public:
     /// \return the results of <tt>(*this).str().compare(str)</tt>
     int compare(string_type const &str) const
     {
-        return this->str().compare(str);
+        return this->compare_(str.begin(), str.end());
     }
 
     /// \overload
     ///
     int compare(sub_match const &sub) const
     {
-        return this->str().compare(sub.str());
+        return sub.matched
+          ? this->compare_(sub.first, sub.second)
+          : this->compare_(sub.second, sub.second);
     }
 
     /// \overload
     ///
     int compare(value_type const *ptr) const
     {
-        return this->str().compare(ptr);
+        return this->compare_(ptr, ptr + std::char_traits<value_type>::length(ptr));
+    }
+
+    /// \overload
+    ///
+    int compare(value_type const &ch) const
+    {
+        return this->compare_(&ch, &ch + 1);
     }
 
     /// \brief true if this sub-match participated in the full match.
     bool matched;
+
+private:
+    // Compares the characters in place, the same way string_type::compare does.
+    template<typename Iter>
+    int compare_(Iter begin, Iter end) const
+    {
+        typedef std::char_traits<value_type> traits_type;
+        BidiIter cur = this->matched ? this->first : this->second;
+        for(; cur != this->second && begin != end; ++cur, ++begin)
+        {
+            if(traits_type::lt(*cur, *begin))
+            {
+                return -1;
+            }
+            else if(traits_type::lt(*begin, *cur))
+            {
+                return 1;
+            }
+        }
+        return cur != this->second ? 1 : begin != end ? -1 : 0;
+    }
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -202,8 +258,19 @@ inline std::basic_ostream<Char, Traits> &operator <<
     return sout;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief \c hash_value() to make \c sub_match\<\> hashable with \c boost::hash
+/// \param sub the \c sub_match\<\> object to hash
+/// \return the same value \c boost::hash gives for <tt>sub.str()</tt>
+template<typename BidiIter>
+inline std::size_t hash_value(sub_match<BidiIter> const &sub)
+{
+    return sub.matched
+      ? boost::hash_range(sub.first, sub.second)
+      : boost::hash_range(sub.second, sub.second);
+}
 
-// BUGBUG make these more efficient
+// The comparisons below are done in place, without building strings.
 
 template<typename BidiIter>
 bool operator == (sub_match<BidiIter> const &lhs, sub_match<BidiIter> const &rhs)
@@ -244,145 +311,145 @@ bool operator > (sub_match<BidiIter> const &lhs, sub_match<BidiIter> const &rhs)
 template<typename BidiIter>
 bool operator == (typename iterator_value<BidiIter>::type const *lhs, sub_match<BidiIter> const &rhs)
 {
-    return lhs == rhs.str();
+    return rhs.compare(lhs) == 0;
 }
 
 template<typename BidiIter>
 bool operator != (typename iterator_value<BidiIter>::type const *lhs, sub_match<BidiIter> const &rhs)
 {
-    return lhs != rhs.str();
+    return rhs.compare(lhs) != 0;
 }
 
 template<typename BidiIter>
 bool operator < (typename iterator_value<BidiIter>::type const *lhs, sub_match<BidiIter> const &rhs)
 {
-    return lhs < rhs.str();
+    return rhs.compare(lhs) > 0;
 }
 
 template<typename BidiIter>
 bool operator > (typename iterator_value<BidiIter>::type const *lhs, sub_match<BidiIter> const &rhs)
 {
-    return lhs> rhs.str();
+    return rhs.compare(lhs) < 0;
 }
 
 template<typename BidiIter>
 bool operator >= (typename iterator_value<BidiIter>::type const *lhs, sub_match<BidiIter> const &rhs)
 {
-    return lhs >= rhs.str();
+    return rhs.compare(lhs) <= 0;
 }
 
 template<typename BidiIter>
 bool operator <= (typename iterator_value<BidiIter>::type const *lhs, sub_match<BidiIter> const &rhs)
 {
-    return lhs <= rhs.str();
+    return rhs.compare(lhs) >= 0;
 }
 
 template<typename BidiIter>
 bool operator == (sub_match<BidiIter> const &lhs, typename iterator_value<BidiIter>::type const *rhs)
 {
-    return lhs.str() == rhs;
+    return lhs.compare(rhs) == 0;
 }
 
 template<typename BidiIter>
 bool operator != (sub_match<BidiIter> const &lhs, typename iterator_value<BidiIter>::type const *rhs)
 {
-    return lhs.str() != rhs;
+    return lhs.compare(rhs) != 0;
 }
 
 template<typename BidiIter>
 bool operator < (sub_match<BidiIter> const &lhs, typename iterator_value<BidiIter>::type const *rhs)
 {
-    return lhs.str() < rhs;
+    return lhs.compare(rhs) < 0;
 }
 
 template<typename BidiIter>
 bool operator > (sub_match<BidiIter> const &lhs, typename iterator_value<BidiIter>::type const *rhs)
 {
-    return lhs.str() > rhs;
+    return lhs.compare(rhs) > 0;
 }
 
 template<typename BidiIter>
 bool operator >= (sub_match<BidiIter> const &lhs, typename iterator_value<BidiIter>::type const *rhs)
 {
-    return lhs.str() >= rhs;
+    return lhs.compare(rhs) >= 0;
 }
 
 template<typename BidiIter>
 bool operator <= (sub_match<BidiIter> const &lhs, typename iterator_value<BidiIter>::type const *rhs)
 {
-    return lhs.str() <= rhs;
+    return lhs.compare(rhs) <= 0;
 }
 
 template<typename BidiIter>
 bool operator == (typename iterator_value<BidiIter>::type const &lhs, sub_match<BidiIter> const &rhs)
 {
-    return lhs == rhs.str();
+    return rhs.compare(lhs) == 0;
 }
 
 template<typename BidiIter>
 bool operator != (typename iterator_value<BidiIter>::type const &lhs, sub_match<BidiIter> const &rhs)
 {
-    return lhs != rhs.str();
+    return rhs.compare(lhs) != 0;
 }
 
 template<typename BidiIter>
 bool operator < (typename iterator_value<BidiIter>::type const &lhs, sub_match<BidiIter> const &rhs)
 {
-    return lhs < rhs.str();
+    return rhs.compare(lhs) > 0;
 }
 
 template<typename BidiIter>
 bool operator > (typename iterator_value<BidiIter>::type const &lhs, sub_match<BidiIter> const &rhs)
 {
-    return lhs> rhs.str();
+    return rhs.compare(lhs) < 0;
 }
 
 template<typename BidiIter>
 bool operator >= (typename iterator_value<BidiIter>::type const &lhs, sub_match<BidiIter> const &rhs)
 {
-    return lhs >= rhs.str();
+    return rhs.compare(lhs) <= 0;
 }
 
 template<typename BidiIter>
 bool operator <= (typename iterator_value<BidiIter>::type const &lhs, sub_match<BidiIter> const &rhs)
 {
-    return lhs <= rhs.str();
+    return rhs.compare(lhs) >= 0;
 }
 
 template<typename BidiIter>
 bool operator == (sub_match<BidiIter> const &lhs, typename iterator_value<BidiIter>::type const &rhs)
 {
-    return lhs.str() == rhs;
+    return lhs.compare(rhs) == 0;
 }
 
 template<typename BidiIter>
 bool operator != (sub_match<BidiIter> const &lhs, typename iterator_value<BidiIter>::type const &rhs)
 {
-    return lhs.str() != rhs;
+    return lhs.compare(rhs) != 0;
 }
 
 template<typename BidiIter>
 bool operator < (sub_match<BidiIter> const &lhs, typename iterator_value<BidiIter>::type const &rhs)
 {
-    return lhs.str() < rhs;
+    return lhs.compare(rhs) < 0;
 }
 
 template<typename BidiIter>
 bool operator > (sub_match<BidiIter> const &lhs, typename iterator_value<BidiIter>::type const &rhs)
 {
-    return lhs.str() > rhs;
+    return lhs.compare(rhs) > 0;
 }
 
 template<typename BidiIter>
 bool operator >= (sub_match<BidiIter> const &lhs, typename iterator_value<BidiIter>::type const &rhs)
 {
-    return lhs.str() >= rhs;
+    return lhs.compare(rhs) >= 0;
 }
 
 template<typename BidiIter>
 bool operator <= (sub_match<BidiIter> const &lhs, typename iterator_value<BidiIter>::type const &rhs)
 {
-    return lhs.str() <= rhs;
+    return lhs.compare(rhs) <= 0;
 }
 
 // Operator+ convenience function
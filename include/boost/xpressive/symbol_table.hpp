@@ -0,0 +1,213 @@
+///////////////////////////////////////////////////////////////////////////////
+/// \file symbol_table.hpp
+/// Contains the definition of the symbol_table\<\> class template, a symbol
+/// table that a static regex refers to, and whose keys can be replaced while
+/// the regex is in use.
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_XPRESSIVE_SYMBOL_TABLE_HPP_EAN_10_04_2005
+#define BOOST_XPRESSIVE_SYMBOL_TABLE_HPP_EAN_10_04_2005
+
+// MS compatible compilers support #pragma once
+#if defined(_MSC_VER)
+# pragma once
+#endif
+
+#include <boost/shared_ptr.hpp>
+#include <boost/range/value_type.hpp>
+#include <boost/xpressive/regex_traits.hpp>
+#include <boost/xpressive/regex_constants.hpp>
+#include <boost/xpressive/detail/core/quant_style.hpp>
+#include <boost/xpressive/detail/core/state.hpp>
+#include <boost/xpressive/detail/core/matcher/attr_matcher.hpp>
+#include <boost/xpressive/detail/utility/symbols.hpp>
+
+namespace boost { namespace xpressive
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// symbol_table
+//
+/// \brief Class template symbol_table\<\> is a symbol table whose keys can be
+/// replaced while static regexes that use it are matching.
+///
+/// A regex like <tt>(a1 = map)</tt> copies the map when it is built. A regex
+/// like <tt>(a1 = table)</tt>, where table is a symbol_table\<\>, refers to the
+/// table instead. assign() replaces the keys, safely even while other threads
+/// are matching. Copies of a symbol_table\<\> refer to the same table.
+///
+/// A search takes the table's map the first time it looks up a key, and keeps
+/// it until the search is over. Every lookup in that search sees the same keys,
+/// and the attribute stays valid for the semantic actions that read it, even
+/// those that run after a keep(), before() or after() around the lookup.
+template<typename Map>
+struct symbol_table
+{
+    typedef Map map_type;
+    typedef typename range_value<Map>::type value_type;
+    typedef typename value_type::first_type key_type;
+    typedef typename value_type::second_type mapped_type;
+    typedef typename range_value<key_type>::type char_type;
+    typedef regex_traits<char_type> traits_type;
+
+    /// Makes a table with no keys.
+    ///
+    /// \param flags If flags \& icase, keys are found regardless of case.
+    explicit symbol_table(regex_constants::syntax_option_type flags = regex_constants::ECMAScript)
+      : impl_(new impl(0 != (flags & regex_constants::icase_)))
+    {
+    }
+
+    /// \param map   The keys to find and the values of the attributes.
+    /// \param flags If flags \& icase, keys are found regardless of case.
+    explicit symbol_table(Map const &map, regex_constants::syntax_option_type flags = regex_constants::ECMAScript)
+      : impl_(new impl(0 != (flags & regex_constants::icase_)))
+    {
+        this->assign(map);
+    }
+
+    /// Replaces the keys of this table, and of every copy of it. Searches that
+    /// start afterward see the new keys.
+    ///
+    /// \param map The new keys and values. The table keeps a copy.
+    void assign(Map const &map)
+    {
+        shared_ptr<snapshot const> snap(new snapshot(map, this->impl_->icase_));
+        boost::atomic_store(&this->impl_->current_, snap);
+    }
+
+    /// Returns a copy of the map that searches look up keys in now.
+    ///
+    Map map() const
+    {
+        shared_ptr<snapshot const> snap = this->current_();
+        return snap ? snap->map_ : Map();
+    }
+
+private:
+    template<typename Matcher, typename Traits, typename ICase>
+    friend struct detail::attr_matcher;
+
+    /// INTERNAL ONLY
+    ///
+    struct snapshot
+    {
+        snapshot(Map const &map, bool icase)
+          : map_(map)
+          , sym_()
+          , traits_()
+          , icase_(icase)
+        {
+            if(this->icase_)
+            {
+                this->sym_.load(this->map_, detail::char_translate<traits_type, true>(this->traits_));
+            }
+            else
+            {
+                this->sym_.load(this->map_, detail::char_translate<traits_type, false>(this->traits_));
+            }
+        }
+
+        template<typename BidiIter>
+        mapped_type const *find(BidiIter &begin, BidiIter end) const
+        {
+            if(this->icase_)
+            {
+                return this->sym_(begin, end, detail::char_translate<traits_type, true>(this->traits_));
+            }
+            return this->sym_(begin, end, detail::char_translate<traits_type, false>(this->traits_));
+        }
+
+        Map const map_;
+        detail::symbols<Map> sym_;
+        traits_type traits_;
+        bool icase_;
+    };
+
+    /// INTERNAL ONLY
+    ///
+    struct impl
+    {
+        explicit impl(bool icase)
+          : current_()
+          , icase_(icase)
+        {
+        }
+
+        shared_ptr<snapshot const> current_;
+        bool const icase_;
+    };
+
+    /// INTERNAL ONLY
+    ///
+    shared_ptr<snapshot const> current_() const
+    {
+        return boost::atomic_load(&this->impl_->current_);
+    }
+
+    shared_ptr<impl> impl_;
+};
+
+namespace detail
+{
+    ///////////////////////////////////////////////////////////////////////////////
+    // attr_matcher
+    //  Note: the Matcher is a symbol_table; it decides for itself whether case
+    //  matters. The state pins the snapshot it finds until the search is over,
+    //  so the table is read once per search rather than at every position.
+    template<typename Map, typename Traits, typename ICase>
+    struct attr_matcher<symbol_table<Map>, Traits, ICase>
+      : quant_style<quant_none, 0, false>
+    {
+        typedef typename symbol_table<Map>::mapped_type const *result_type;
+
+        attr_matcher(int slot, symbol_table<Map> const &table, Traits const &)
+          : slot_(slot-1)
+          , table_(table)
+        {
+        }
+
+        template<typename BidiIter, typename Next>
+        bool match(match_state<BidiIter> &state, Next const &next) const
+        {
+            typedef typename symbol_table<Map>::snapshot snapshot;
+            void const *key = this->table_.impl_.get();
+            shared_ptr<void const> const *pin = state.find_pin(key);
+            if(!pin)
+            {
+                pin = &state.pin(key, this->table_.current_());
+            }
+
+            snapshot const *snap = static_cast<snapshot const *>(pin->get());
+            if(!snap)
+            {
+                return false;
+            }
+
+            BidiIter tmp = state.cur_;
+            result_type result = snap->find(state.cur_, state.end_);
+            if(result)
+            {
+                void const *old_slot = state.attr_context_.attr_slots_[this->slot_];
+                state.attr_context_.attr_slots_[this->slot_] = &*result;
+                if(next.match(state))
+                {
+                    return true;
+                }
+                state.attr_context_.attr_slots_[this->slot_] = old_slot;
+            }
+            state.cur_ = tmp;
+            return false;
+        }
+
+        int slot_;
+        symbol_table<Map> table_;
+    };
+}
+
+}} // namespace boost::xpressive
+
+#endif
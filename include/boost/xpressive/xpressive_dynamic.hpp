@@ -18,8 +18,11 @@
 #include <boost/xpressive/basic_regex.hpp>
 #include <boost/xpressive/sub_match.hpp>
 #include <boost/xpressive/match_results.hpp>
+#include <boost/xpressive/basic_formatter.hpp>
 #include <boost/xpressive/regex_algorithms.hpp>
+#include <boost/xpressive/dictionary.hpp>
 #include <boost/xpressive/regex_iterator.hpp>
 #include <boost/xpressive/regex_token_iterator.hpp>
+#include <boost/xpressive/regex_context.hpp>
 
 #endif
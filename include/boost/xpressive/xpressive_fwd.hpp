@@ -104,12 +104,27 @@ namespace boost { namespace xpressive
     template<typename BidiIter>
     struct match_results;
 
+    template<typename BidiIter>
+    struct basic_formatter;
+
+    template<typename Map>
+    struct dictionary;
+
+    template<typename Map>
+    struct symbol_table;
+
+    template<typename Char, typename Value>
+    struct mapped_symbols;
+
     template<typename BidiIter>
     struct regex_iterator;
 
     template<typename BidiIter>
     struct regex_token_iterator;
 
+    template<typename BidiIter>
+    struct regex_context;
+
     template<typename BidiIter>
     struct regex_id_filter_predicate;
 
@@ -203,6 +218,14 @@ namespace boost { namespace xpressive
     typedef regex_compiler<wchar_t const *>                         wcregex_compiler;
     #endif
 
+    typedef basic_formatter<std::string::const_iterator>            sformatter;
+    typedef basic_formatter<char const *>                           cformatter;
+
+    #ifndef BOOST_XPRESSIVE_NO_WREGEX
+    typedef basic_formatter<std::wstring::const_iterator>           wsformatter;
+    typedef basic_formatter<wchar_t const *>                        wcformatter;
+    #endif
+
     typedef regex_iterator<std::string::const_iterator>             sregex_iterator;
     typedef regex_iterator<char const *>                            cregex_iterator;
 
@@ -219,6 +242,14 @@ namespace boost { namespace xpressive
     typedef regex_token_iterator<wchar_t const *>                   wcregex_token_iterator;
     #endif
 
+    typedef regex_context<std::string::const_iterator>              sregex_context;
+    typedef regex_context<char const *>                             cregex_context;
+
+    #ifndef BOOST_XPRESSIVE_NO_WREGEX
+    typedef regex_context<std::wstring::const_iterator>             wsregex_context;
+    typedef regex_context<wchar_t const *>                          wcregex_context;
+    #endif
+
     typedef match_results<std::string::const_iterator>              smatch;
     typedef match_results<char const *>                             cmatch;
 
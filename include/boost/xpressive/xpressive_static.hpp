@@ -26,7 +26,11 @@
 #include <boost/xpressive/sub_match.hpp>
 #include <boost/xpressive/match_results.hpp>
 #include <boost/xpressive/regex_algorithms.hpp>
+#include <boost/xpressive/dictionary.hpp>
+#include <boost/xpressive/symbol_table.hpp>
+#include <boost/xpressive/mapped_symbols.hpp>
 #include <boost/xpressive/regex_iterator.hpp>
 #include <boost/xpressive/regex_token_iterator.hpp>
+#include <boost/xpressive/regex_context.hpp>
 
 #endif
@@ -234,6 +234,77 @@ void test6()
     BOOST_CHECK("9*(10+3)" == what[0]);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// test that copies of a token iterator part way through a match yield the
+// remaining tokens of that match
+//
+void test7()
+{
+    std::string str("a=1;bb=22;ccc=333");
+    sregex rx = sregex::compile("(\\w+)=(\\d+)");
+    int const subs[] = {-1, 2, 1};
+
+    sregex_token_iterator cur(str.begin(), str.end(), rx, subs), end;
+    std::vector<std::string> tokens, copied;
+    while(cur != end)
+    {
+        sregex_token_iterator copy = cur++;
+        tokens.push_back(*copy);
+        if(cur != end)
+        {
+            sregex_token_iterator ahead = cur;
+            if(++ahead != end)
+                copied.push_back(*ahead);
+        }
+    }
+
+    char const *expected[] = {"", "1", "a", ";", "22", "bb", ";", "333", "ccc"};
+    BOOST_REQUIRE_EQUAL(tokens.size(), 9u);
+    for(std::size_t i = 0; i < tokens.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(tokens[i], expected[i]);
+    }
+
+    BOOST_REQUIRE_EQUAL(copied.size(), 7u);
+    for(std::size_t i = 0; i < copied.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(copied[i], expected[i + 2]);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test for groups captured inside look-arounds and keepers, which are put
+// back on backtracking while the groups around them are left alone
+void test8()
+{
+    smatch what;
+    std::string str("qabd");
+
+    sregex rx1 = sregex::compile("(q)(?:(?=(a)(b))abc|(a)bd)");
+    BOOST_REQUIRE(regex_match(str, what, rx1));
+    BOOST_CHECK_EQUAL(what[1].str(), "q");
+    BOOST_CHECK(!what[2].matched);
+    BOOST_CHECK(!what[3].matched);
+    BOOST_CHECK_EQUAL(what[4].str(), "a");
+
+    sregex rx2 = sregex::compile("(q)(?:(?>(a)(?=(b)))bc|(?<=(q))(a)(?<=(a))bd)");
+    BOOST_REQUIRE(regex_match(str, what, rx2));
+    BOOST_CHECK_EQUAL(what[1].str(), "q");
+    BOOST_CHECK(!what[2].matched);
+    BOOST_CHECK(!what[3].matched);
+    BOOST_CHECK_EQUAL(what[4].str(), "q");
+    BOOST_CHECK_EQUAL(what[5].str(), "a");
+    BOOST_CHECK_EQUAL(what[6].str(), "a");
+
+    mark_tag q(1), a(2), b(3), c(4);
+    sregex rx3 = (q= 'q') >> ((keep(a= 'a' >> before(b= 'b')) >> "bc") | ((c= 'a') >> "bd"));
+    BOOST_REQUIRE(regex_match(str, what, rx3));
+    BOOST_CHECK_EQUAL(what[q].str(), "q");
+    BOOST_CHECK(!what[a].matched);
+    BOOST_CHECK(!what[b].matched);
+    BOOST_CHECK_EQUAL(what[c].str(), "a");
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // init_unit_test_suite
 //
@@ -247,6 +318,8 @@ test_suite* init_unit_test_suite( int argc, char* argv[] )
     test->add(BOOST_TEST_CASE(&test4));
     test->add(BOOST_TEST_CASE(&test5));
     test->add(BOOST_TEST_CASE(&test6));
+    test->add(BOOST_TEST_CASE(&test7));
+    test->add(BOOST_TEST_CASE(&test8));
 
     return test;
 }
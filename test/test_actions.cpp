@@ -10,6 +10,7 @@
 #include <map>
 #include <list>
 #include <stack>
+#include <vector>
 #include <numeric>
 #include <boost/version.hpp>
 #include <boost/xpressive/xpressive_static.hpp>
@@ -268,6 +269,116 @@ void test7()
     BOOST_CHECK_EQUAL(text, "This is a !!! string ??? and stuff.");
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// test8
+//  Test that as<>() converts integers the same way lexical_cast does
+template<typename T>
+void check_as(std::string const &str)
+{
+    using namespace boost::xpressive;
+    smatch what;
+    sregex rx = (s1= *_);
+    BOOST_REQUIRE(regex_match(str, what, rx));
+
+    std::list<char> lst(str.begin(), str.end());
+    match_results<std::list<char>::iterator> lwhat;
+    basic_regex<std::list<char>::iterator> lrx = (s1= *_);
+    BOOST_REQUIRE(regex_match(lst.begin(), lst.end(), lwhat, lrx));
+
+    try
+    {
+        T expected = boost::lexical_cast<T>(str);
+        BOOST_CHECK(op::as<T>()(what[1]) == expected);
+        BOOST_CHECK(op::as<T>()(lwhat[1]) == expected);
+    }
+    catch(boost::bad_lexical_cast const &)
+    {
+        BOOST_CHECK_THROW(op::as<T>()(what[1]), boost::bad_lexical_cast);
+        BOOST_CHECK_THROW(op::as<T>()(lwhat[1]), boost::bad_lexical_cast);
+    }
+}
+
+void test8()
+{
+    char const *inputs[] = {
+        "0", "7", "-7", "+7", "007", "-0", "", "-", "+", "1x", " 1", "1.5",
+        "127", "128", "-128", "-129", "255", "256", "32767", "32768", "-32768", "-32769",
+        "65535", "65536", "2147483647", "2147483648", "-2147483648", "-2147483649",
+        "4294967295", "4294967296", "9223372036854775807", "9223372036854775808",
+        "-9223372036854775808", "-9223372036854775809", "18446744073709551615",
+        "18446744073709551616", "99999999999999999999999"
+    };
+
+    for(std::size_t i = 0; i < sizeof(inputs) / sizeof(*inputs); ++i)
+    {
+        check_as<short>(inputs[i]);
+        check_as<unsigned short>(inputs[i]);
+        check_as<int>(inputs[i]);
+        check_as<long>(inputs[i]);
+        check_as<unsigned long>(inputs[i]);
+        check_as<double>(inputs[i]);
+#ifdef BOOST_HAS_LONG_LONG
+        check_as<boost::long_long_type>(inputs[i]);
+        check_as<boost::ulong_long_type>(inputs[i]);
+#endif
+    }
+
+    // unsigned types keep lexical_cast's handling of a minus sign
+    check_as<unsigned int>("-1");
+    check_as<unsigned int>("5");
+    check_as<char>("5");
+    check_as<std::string>("-12");
+
+    using namespace boost::xpressive;
+    std::string str("1 -22 333 +4444");
+    std::vector<int> result;
+    sregex rx = (s1= !as_xpr('-') >> +_d)[ xp::push_back(xp::ref(result), as<int>(s1)) ] >> ~before(_d);
+    for(sregex_iterator cur(str.begin(), str.end(), rx), end; cur != end; ++cur)
+        ;
+    BOOST_REQUIRE_EQUAL(result.size(), 4u);
+    BOOST_CHECK_EQUAL(result[1], -22);
+    BOOST_CHECK_EQUAL(result[3], 4444);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test9
+//  several late-bound action arguments, and binding one again
+void test9()
+{
+    using namespace boost::xpressive;
+    placeholder<std::map<std::string, int> > const _map = {{}};
+    placeholder<int> const _count = {{}};
+    placeholder<std::vector<std::string> > const _keys = {{}};
+
+    sregex pair = ( (s1= +_w) >> "=>" >> (s2= +_d) )
+        [ _map[s1] = as<int>(s2), ++_count, xp::push_back(_keys, s1) ];
+    sregex rx = pair >> *(+_s >> pair);
+
+    std::string str("aaa=>1 bbb=>23 ccc=>456");
+    std::map<std::string, int> result;
+    std::vector<std::string> keys;
+    int count = 0, other = 0;
+
+    smatch what;
+    what.let(_map = result).let(_count = count).let(_keys = keys);
+    BOOST_REQUIRE(regex_match(str, what, rx));
+    BOOST_CHECK_EQUAL(result["ccc"], 456);
+    BOOST_CHECK_EQUAL(count, 3);
+    BOOST_REQUIRE_EQUAL(keys.size(), 3u);
+    BOOST_CHECK_EQUAL(keys[1], "bbb");
+
+    what.let(_count = other);
+    BOOST_REQUIRE(regex_match(str, what, rx));
+    BOOST_CHECK_EQUAL(count, 3);
+    BOOST_CHECK_EQUAL(other, 3);
+    BOOST_CHECK_EQUAL(keys.size(), 6u);
+
+    // copies keep the bindings
+    smatch copy(what);
+    BOOST_REQUIRE(regex_match(str, copy, rx));
+    BOOST_CHECK_EQUAL(other, 6);
+}
+
 using namespace boost::unit_test;
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -284,6 +395,8 @@ test_suite* init_unit_test_suite( int argc, char* argv[] )
     test->add(BOOST_TEST_CASE(&test5));
     test->add(BOOST_TEST_CASE(&test6));
     test->add(BOOST_TEST_CASE(&test7));
+    test->add(BOOST_TEST_CASE(&test8));
+    test->add(BOOST_TEST_CASE(&test9));
     return test;
 }
 
@@ -0,0 +1,142 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_adaptive_symbols.cpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+//  Test that symbol tables find the same keys while they adapt to the
+//  lookups, from one thread and from several.
+
+#define BOOST_XPRESSIVE_USE_ADAPTIVE_SYMBOLS
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/xpressive/xpressive_static.hpp>
+#include <boost/xpressive/regex_actions.hpp>
+#include <boost/test/unit_test.hpp>
+
+#if defined(BOOST_XPRESSIVE_HAS_ADAPTIVE_SYMBOLS) && !defined(BOOST_NO_CXX11_HDR_THREAD)
+# include <thread>
+# define TEST_THREADS
+#endif
+
+using namespace boost::unit_test;
+using namespace boost::xpressive;
+
+typedef std::map<std::string, int> int_map;
+
+///////////////////////////////////////////////////////////////////////////////
+// make_map
+//   the names of the numbers 0 through 1999
+int_map make_map()
+{
+    int_map map;
+    for(int i = 0; i < 2000; ++i)
+    {
+        std::string key;
+        for(int j = i; j != 0 || key.empty(); j /= 10)
+        {
+            key.insert(key.begin(), char('0' + j % 10));
+        }
+        map[key] = i;
+    }
+    return map;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// lookup
+//   look up keys, mostly a few hot ones, and count the wrong answers
+int lookup(sregex const &rx, int_map const &map, int count, int seed)
+{
+    std::vector<int_map::const_iterator> keys;
+    for(int_map::const_iterator it = map.begin(); it != map.end(); ++it)
+    {
+        keys.push_back(it);
+    }
+
+    int errors = 0;
+    smatch what;
+    unsigned rand = static_cast<unsigned>(seed);
+    for(int i = 0; i < count; ++i)
+    {
+        rand = rand * 1103515245u + 12345u;
+        std::size_t k = (rand >> 16) % keys.size();
+        if(0 != i % 8)
+        {
+            k = (k % 10) * 97;
+        }
+
+        if(!regex_match(keys[k]->first, what, rx) || what.str(1) != keys[k]->first)
+        {
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_one_thread
+void test_one_thread()
+{
+    int_map const map = make_map();
+    int result = -1;
+    sregex rx = (s1= (a1=map)[ boost::xpressive::ref(result) = a1 ]);
+
+    BOOST_CHECK_EQUAL(lookup(rx, map, 500000, 1), 0);
+
+    // after adapting, every key is still found
+    for(int_map::const_iterator it = map.begin(); it != map.end(); ++it)
+    {
+        if(!regex_match(it->first, rx) || result != it->second)
+        {
+            BOOST_ERROR("key not found: " << it->first);
+        }
+    }
+    BOOST_CHECK(!regex_match(std::string("20000"), rx));
+    BOOST_CHECK(!regex_match(std::string("x"), rx));
+}
+
+#ifdef TEST_THREADS
+///////////////////////////////////////////////////////////////////////////////
+// test_threads
+void test_threads()
+{
+    int_map const map = make_map();
+    sregex const rx = (s1= (a1=map)[ a1 ]);
+
+    std::vector<int> errors(4, 0);
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i < errors.size(); ++i)
+    {
+        int *err = &errors[i];
+        threads.push_back(std::thread([&rx, &map, err, i]
+        {
+            *err = lookup(rx, map, 300000, static_cast<int>(i) + 1);
+        }));
+    }
+    for(std::size_t i = 0; i < threads.size(); ++i)
+    {
+        threads[i].join();
+    }
+
+    for(std::size_t i = 0; i < errors.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(errors[i], 0);
+    }
+}
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// init_unit_test_suite
+//
+test_suite* init_unit_test_suite( int argc, char* argv[] )
+{
+    test_suite *test = BOOST_TEST_SUITE("test adaptive symbol tables");
+    test->add(BOOST_TEST_CASE(&test_one_thread));
+#ifdef TEST_THREADS
+    test->add(BOOST_TEST_CASE(&test_threads));
+#endif
+    return test;
+}
@@ -0,0 +1,268 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_allocator.cpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+//  Test match_results objects that get their memory from a user-supplied allocator.
+
+#include <new>
+#include <string>
+#include <cstddef>
+#include <boost/config.hpp>
+#include <boost/xpressive/xpressive.hpp>
+#include <boost/test/unit_test.hpp>
+#if !defined(BOOST_NO_CXX17_HDR_MEMORY_RESOURCE) && __cplusplus >= 201703L
+# define BOOST_XPRESSIVE_TEST_MEMORY_RESOURCE
+# include <memory_resource>
+#endif
+
+using namespace boost::unit_test;
+using namespace boost::xpressive;
+
+///////////////////////////////////////////////////////////////////////////////
+// counting_allocator
+//   keeps track of how many bytes it has handed out and not taken back
+static std::size_t live_bytes = 0;
+static std::size_t allocations = 0;
+
+template<typename T>
+struct counting_allocator
+{
+    typedef T value_type;
+    typedef T *pointer;
+    typedef T const *const_pointer;
+    typedef T &reference;
+    typedef T const &const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template<typename U>
+    struct rebind
+    {
+        typedef counting_allocator<U> other;
+    };
+
+    counting_allocator()
+    {
+    }
+
+    template<typename U>
+    counting_allocator(counting_allocator<U> const &)
+    {
+    }
+
+    T *allocate(std::size_t n, void const * = 0)
+    {
+        live_bytes += n * sizeof(T);
+        ++allocations;
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, std::size_t n)
+    {
+        BOOST_REQUIRE(live_bytes >= n * sizeof(T));
+        live_bytes -= n * sizeof(T);
+        ::operator delete(p);
+    }
+
+    std::size_t max_size() const
+    {
+        return std::size_t(-1) / sizeof(T);
+    }
+
+    void construct(T *p, T const &t)
+    {
+        ::new((void *)p) T(t);
+    }
+
+    void destroy(T *p)
+    {
+        p->~T();
+    }
+
+    bool operator ==(counting_allocator<T> const &) const
+    {
+        return true;
+    }
+
+    bool operator !=(counting_allocator<T> const &) const
+    {
+        return false;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// test_dynamic
+void test_dynamic()
+{
+    sregex rx = sregex::compile("(\\w+)=(\\d+)");
+    std::string str("  key=123456;");
+    {
+        smatch what((counting_allocator<char>()));
+        BOOST_REQUIRE(regex_search(str, what, rx));
+        BOOST_CHECK_EQUAL(what[1].str(), "key");
+        BOOST_CHECK_EQUAL(what[2].str(), "123456");
+        BOOST_CHECK(0 != live_bytes);
+    }
+    BOOST_CHECK_EQUAL(live_bytes, 0u);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_nested
+void test_nested()
+{
+    sregex word = +_w;
+    sregex pair = (s1= word) >> '=' >> (s2= +_d);
+    sregex pairs = pair >> *(',' >> pair);
+    std::string str("a=1,bb=22,ccc=333");
+
+    {
+        smatch what((counting_allocator<char>()));
+        for(int i = 0; i < 3; ++i)
+        {
+            BOOST_REQUIRE(regex_match(str, what, pairs));
+            BOOST_CHECK_EQUAL(what.nested_results().size(), 3u);
+            BOOST_CHECK_EQUAL(what.nested_results().back()[1].str(), "ccc");
+            BOOST_CHECK_EQUAL(what.nested_results().back()[2].str(), "333");
+        }
+
+        // repeated matches reuse the cached storage
+        std::size_t before = allocations;
+        BOOST_REQUIRE(regex_match(str, what, pairs));
+        BOOST_CHECK_EQUAL(before, allocations);
+
+        // copies use the global heap
+        smatch copy(what);
+        BOOST_CHECK_EQUAL(before, allocations);
+        BOOST_CHECK_EQUAL(copy.nested_results().size(), 3u);
+        BOOST_CHECK_EQUAL(copy.nested_results().front()[1].str(), "a");
+
+        // assignment keeps the allocator of the object assigned to
+        smatch other((counting_allocator<char>()));
+        other = copy;
+        BOOST_CHECK_LT(before, allocations);
+        BOOST_CHECK_EQUAL(other.nested_results().size(), 3u);
+        BOOST_REQUIRE(regex_match(std::string("x=0"), other, pairs));
+        BOOST_CHECK_EQUAL(other.nested_results().size(), 1u);
+
+        // swap exchanges the allocators along with the results
+        swap(other, copy);
+        BOOST_CHECK_EQUAL(copy.nested_results().size(), 1u);
+        BOOST_CHECK_EQUAL(other.nested_results().size(), 3u);
+        BOOST_REQUIRE(regex_match(str, copy, pairs));
+        BOOST_CHECK_EQUAL(copy.nested_results().size(), 3u);
+    }
+    BOOST_CHECK_EQUAL(live_bytes, 0u);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_few_groups
+//   a regex with few groups needs only one allocation for its sub-matches
+void test_few_groups()
+{
+    sregex rx = sregex::compile("(\\w+)=(\\d+)(;)?");
+    std::string str("  key=123456;");
+    {
+        smatch what((counting_allocator<char>()));
+        std::size_t before = allocations;
+        BOOST_REQUIRE(regex_search(str, what, rx));
+        BOOST_CHECK_EQUAL(before + 1, allocations);
+        BOOST_CHECK_EQUAL(what[1].str(), "key");
+        BOOST_CHECK_EQUAL(what[3].str(), ";");
+
+        // more groups than fit inline
+        sregex big = sregex::compile("(a)(b)(c)(d)(e)(f)(g)(h)(i)(j)(k)(l)(m)(n)(o)(p)(q)(r)(s)(t)");
+        std::string abc("abcdefghijklmnopqrst");
+        BOOST_REQUIRE(regex_match(abc, what, big));
+        BOOST_CHECK_EQUAL(what[20].str(), "t");
+        BOOST_REQUIRE(regex_search(str, what, rx));
+        BOOST_CHECK_EQUAL(what[2].str(), "123456");
+    }
+    BOOST_CHECK_EQUAL(live_bytes, 0u);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_retained_bytes
+void test_retained_bytes()
+{
+    sregex pair = (s1= +_w) >> '=' >> (s2= +_d);
+    sregex pairs = pair >> *(',' >> pair);
+    sregex deep = sregex::compile("((((((((((((((((((((((((x))))))))))))))))))))))))");
+
+    std::string many("a=1");
+    for(int i = 0; i < 500; ++i)
+        many += ",b=2";
+    std::string few("c=3");
+
+    {
+        smatch what((counting_allocator<char>()));
+        BOOST_CHECK_EQUAL(what.retained_bytes(), 0u);
+        BOOST_CHECK_EQUAL(what.max_retained_bytes(), BOOST_XPRESSIVE_MAX_RETAINED_BYTES);
+
+        BOOST_REQUIRE(regex_match(many, what, pairs));
+        BOOST_REQUIRE(regex_match(std::string("x"), what, deep));
+        BOOST_REQUIRE(regex_match(few, what, pairs));
+        std::size_t peak = what.retained_bytes();
+        BOOST_CHECK_LT(0u, peak);
+
+        // by default, everything is kept
+        BOOST_REQUIRE(regex_match(few, what, pairs));
+        BOOST_CHECK_EQUAL(what.retained_bytes(), peak);
+
+        // with a limit, the surplus is freed before the next match
+        std::size_t live = live_bytes;
+        what.max_retained_bytes(peak / 4);
+        BOOST_CHECK_EQUAL(what.max_retained_bytes(), peak / 4);
+        BOOST_REQUIRE(regex_match(few, what, pairs));
+        BOOST_CHECK_EQUAL(what.nested_results().size(), 1u);
+        BOOST_CHECK_EQUAL(what.nested_results().front()[1].str(), "c");
+        BOOST_CHECK_LE(what.retained_bytes(), peak / 4);
+        BOOST_CHECK_LT(live_bytes, live);
+
+        // memory needed by a match is still allocated
+        BOOST_REQUIRE(regex_match(many, what, pairs));
+        BOOST_CHECK_EQUAL(what.nested_results().size(), 501u);
+        BOOST_REQUIRE(regex_match(few, what, pairs));
+        BOOST_CHECK_LE(what.retained_bytes(), peak / 4);
+
+        // assignment keeps the limit
+        smatch copy(what);
+        what = copy;
+        BOOST_CHECK_EQUAL(what.max_retained_bytes(), peak / 4);
+    }
+    BOOST_CHECK_EQUAL(live_bytes, 0u);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_memory_resource
+void test_memory_resource()
+{
+#ifdef BOOST_XPRESSIVE_TEST_MEMORY_RESOURCE
+    static char buffer[65536];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+
+    sregex rx = sregex::compile("(\\w+)@(\\w+)\\.com");
+    std::string str("mail eric@boost.com now");
+    std::pmr::polymorphic_allocator<char> alloc(&arena);
+    smatch what(alloc);
+    BOOST_REQUIRE(regex_search(str, what, rx));
+    BOOST_CHECK_EQUAL(what[1].str(), "eric");
+    BOOST_CHECK_EQUAL(what[2].str(), "boost");
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// init_unit_test_suite
+//
+test_suite* init_unit_test_suite( int argc, char* argv[] )
+{
+    test_suite *test = BOOST_TEST_SUITE("test match_results with custom allocators");
+    test->add(BOOST_TEST_CASE(&test_dynamic));
+    test->add(BOOST_TEST_CASE(&test_nested));
+    test->add(BOOST_TEST_CASE(&test_few_groups));
+    test->add(BOOST_TEST_CASE(&test_retained_bytes));
+    test->add(BOOST_TEST_CASE(&test_memory_resource));
+    return test;
+}
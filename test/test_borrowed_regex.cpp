@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_borrowed_regex.cpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+//  Test iterators that use a regex in place rather than copying it.
+
+#include <string>
+#include <vector>
+#include <boost/ref.hpp>
+#include <boost/xpressive/xpressive.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::unit_test;
+using namespace boost::xpressive;
+
+///////////////////////////////////////////////////////////////////////////////
+// test_regex_iterator
+void test_regex_iterator()
+{
+    std::string str("a=1, bb=22, ccc=333");
+    sregex const rx = sregex::compile("(\\w+)=(\\d+)");
+
+    sregex_iterator owned(str.begin(), str.end(), rx), end;
+    sregex_iterator borrowed(str.begin(), str.end(), boost::cref(rx));
+
+    for(; owned != end; ++owned, ++borrowed)
+    {
+        BOOST_REQUIRE(borrowed != end);
+        BOOST_CHECK_EQUAL((*owned)[1].str(), (*borrowed)[1].str());
+        BOOST_CHECK_EQUAL((*owned)[2].str(), (*borrowed)[2].str());
+        BOOST_CHECK_EQUAL(owned->position(), borrowed->position());
+    }
+    BOOST_CHECK(borrowed == end);
+
+    // copies of a borrowing iterator borrow, too
+    sregex_iterator first(str.begin(), str.end(), boost::cref(rx));
+    sregex_iterator second(first);
+    ++second;
+    BOOST_CHECK_EQUAL((*first)[1].str(), "a");
+    BOOST_CHECK_EQUAL((*second)[1].str(), "bb");
+    ++first;
+    BOOST_CHECK(first == second);
+
+    // an empty regex matches nothing
+    sregex const empty;
+    BOOST_CHECK(sregex_iterator(str.begin(), str.end(), boost::cref(empty)) == end);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_regex_token_iterator
+void test_regex_token_iterator()
+{
+    std::string str("a=1, bb=22, ccc=333");
+    sregex const rx = sregex::compile("(\\w+)=(\\d+)");
+    int const subs[] = {2, 1};
+
+    sregex_token_iterator owned(str.begin(), str.end(), rx, subs), end;
+    sregex_token_iterator borrowed(str.begin(), str.end(), boost::cref(rx), subs);
+
+    std::vector<std::string> tokens;
+    for(; owned != end; ++owned, ++borrowed)
+    {
+        BOOST_REQUIRE(borrowed != end);
+        BOOST_CHECK_EQUAL(owned->str(), borrowed->str());
+        tokens.push_back(*borrowed);
+    }
+    BOOST_CHECK(borrowed == end);
+    BOOST_REQUIRE_EQUAL(tokens.size(), 6u);
+    BOOST_CHECK_EQUAL(tokens[4], "333");
+    BOOST_CHECK_EQUAL(tokens[5], "ccc");
+
+    sregex_token_iterator whole(str.begin(), str.end(), boost::cref(rx));
+    BOOST_REQUIRE(whole != end);
+    BOOST_CHECK_EQUAL(whole->str(), "a=1");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// init_unit_test_suite
+//
+test_suite* init_unit_test_suite( int argc, char* argv[] )
+{
+    test_suite *test = BOOST_TEST_SUITE("test iterators with borrowed regexes");
+    test->add(BOOST_TEST_CASE(&test_regex_iterator));
+    test->add(BOOST_TEST_CASE(&test_regex_token_iterator));
+    return test;
+}
@@ -0,0 +1,129 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_context.cpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+//  Test reusing a regex_context across many searches and matches.
+
+#include <string>
+#include <boost/xpressive/xpressive.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::unit_test;
+using namespace boost::xpressive;
+
+///////////////////////////////////////////////////////////////////////////////
+// test_search
+void test_search()
+{
+    sregex rx = sregex::compile("(\\w+)=(\\d+)");
+    sregex_context ctx(rx);
+
+    std::string fields[] = { "id=42", "x", "  name=7;", "=9", "key=123456" };
+    char const *ones[] = { "id", 0, "name", 0, "key" };
+    char const *twos[] = { "42", 0, "7", 0, "123456" };
+
+    for(int n = 0; n < 3; ++n)
+    {
+        for(int i = 0; i < 5; ++i)
+        {
+            smatch what;
+            bool found = regex_search(fields[i], what, rx);
+            BOOST_CHECK_EQUAL(found, ctx.search(fields[i].begin(), fields[i].end()));
+            BOOST_CHECK_EQUAL(found, 0 != ones[i]);
+            if(found)
+            {
+                BOOST_CHECK_EQUAL(ctx.results().size(), 3u);
+                BOOST_CHECK_EQUAL(ctx.results()[1].str(), ones[i]);
+                BOOST_CHECK_EQUAL(ctx.results()[2].str(), twos[i]);
+                BOOST_CHECK_EQUAL(ctx.results().position(), what.position());
+                BOOST_CHECK(ctx.results().prefix() == what.prefix());
+                BOOST_CHECK(ctx.results().suffix() == what.suffix());
+            }
+            else
+            {
+                BOOST_CHECK(!ctx.results());
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_match
+void test_match()
+{
+    cregex rx = +_d >> '-' >> (s1= +_d);
+    cregex_context ctx(rx);
+
+    char const *str = "123-456";
+    BOOST_CHECK(ctx.match(str, str + 7));
+    BOOST_CHECK_EQUAL(ctx.results()[1].str(), "456");
+    BOOST_CHECK(!ctx.match(str, str + 6 - 3));
+    BOOST_CHECK(!ctx.results());
+    BOOST_CHECK(ctx.search(str, str + 7));
+    BOOST_CHECK(ctx.match(str + 1, str + 5));
+    BOOST_CHECK_EQUAL(ctx.results()[0].str(), "23-4");
+
+    // mixing match() and search() doesn't leak the match_all_ flag
+    BOOST_CHECK(ctx.search(str, str + 5));
+    BOOST_CHECK_EQUAL(ctx.results()[0].str(), "123-4");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_nested
+void test_nested()
+{
+    sregex word = +_w;
+    sregex pair = (s1= word) >> '=' >> (s2= word);
+    sregex_context ctx(pair);
+
+    std::string str("a=b c=d");
+    for(int n = 0; n < 4; ++n)
+    {
+        BOOST_REQUIRE(ctx.search(str.begin(), str.end()));
+        BOOST_CHECK_EQUAL(ctx.results().nested_results().size(), 2u);
+        BOOST_CHECK_EQUAL(ctx.results()[2].str(), "b");
+        BOOST_REQUIRE(ctx.search(str.begin() + 3, str.end()));
+        BOOST_CHECK_EQUAL(ctx.results().nested_results().size(), 2u);
+        BOOST_CHECK_EQUAL(ctx.results()[1].str(), "c");
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_empty
+void test_empty()
+{
+    sregex rx;
+    sregex_context ctx(rx);
+    std::string str("abc");
+    BOOST_CHECK(!ctx.search(str.begin(), str.end()));
+    BOOST_CHECK(!ctx.match(str.begin(), str.end()));
+    BOOST_CHECK(ctx.results().empty());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_flags
+void test_flags()
+{
+    sregex rx = bol >> +_w;
+    sregex_context ctx(rx, regex_constants::match_not_bol);
+    std::string str("abc def");
+    BOOST_CHECK(!ctx.search(str.begin(), str.end()));
+    BOOST_CHECK(ctx.flags() == regex_constants::match_not_bol);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// init_unit_test_suite
+//
+test_suite* init_unit_test_suite( int argc, char* argv[] )
+{
+    test_suite *test = BOOST_TEST_SUITE("test_context");
+    test->add(BOOST_TEST_CASE(&test_search));
+    test->add(BOOST_TEST_CASE(&test_match));
+    test->add(BOOST_TEST_CASE(&test_nested));
+    test->add(BOOST_TEST_CASE(&test_empty));
+    test->add(BOOST_TEST_CASE(&test_flags));
+    return test;
+}
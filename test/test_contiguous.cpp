@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_contiguous.cpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+//  Test that searches over contiguous and non-contiguous sequences agree.
+
+#include <list>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <boost/xpressive/xpressive.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::unit_test;
+using namespace boost::xpressive;
+
+BOOST_STATIC_ASSERT(detail::is_contiguous<char const *>::value);
+BOOST_STATIC_ASSERT(detail::is_contiguous<std::string::const_iterator>::value);
+BOOST_STATIC_ASSERT(!detail::is_contiguous<std::list<char>::const_iterator>::value);
+
+///////////////////////////////////////////////////////////////////////////////
+// positions
+//   the positions of all the matches of rx in [begin, end)
+template<typename BidiIter>
+std::vector<std::ptrdiff_t> positions(BidiIter begin, BidiIter end, basic_regex<BidiIter> const &rx)
+{
+    std::vector<std::ptrdiff_t> result;
+    regex_iterator<BidiIter> cur(begin, end, rx), last;
+    for(; cur != last; ++cur)
+    {
+        result.push_back(cur->position());
+        result.push_back((*cur)[0].length());
+    }
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// check
+//   search str for pattern as a std::string, a char const*, a std::vector<char>
+//   and a std::list<char>
+void check(std::string const &str, char const *pattern)
+{
+    std::list<char> lst(str.begin(), str.end());
+    std::vector<char> vec(str.begin(), str.end());
+    char const *ptr = str.c_str();
+
+    std::vector<std::ptrdiff_t> expected = positions(lst.begin(), lst.end(),
+        basic_regex<std::list<char>::iterator>::compile(pattern));
+    std::vector<std::ptrdiff_t> by_string = positions(str.begin(), str.end(), sregex::compile(pattern));
+    std::vector<std::ptrdiff_t> by_pointer = positions(ptr, ptr + str.size(), cregex::compile(pattern));
+    std::vector<std::ptrdiff_t> by_vector = positions(vec.begin(), vec.end(),
+        basic_regex<std::vector<char>::iterator>::compile(pattern));
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), by_string.begin(), by_string.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), by_pointer.begin(), by_pointer.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), by_vector.begin(), by_vector.end());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_leading_char
+void test_leading_char()
+{
+    check("", "x");
+    check("x", "x");
+    check("abc", "x");
+    check("abcx", "x");
+    check("xabxcxx", "x\\w*");
+    check("a.b.c.", "\\.");
+    check("a.b.c.", "\\.c");
+    check("aXbx", "x");
+    check("aXbx", "(?i)x");
+    check(std::string("a\0b\0", 4), "b");
+
+    // static regexes
+    std::string str("one two three");
+    smatch what;
+    sregex t = 't' >> +_w, x = 'x' >> +_w;
+    BOOST_REQUIRE(regex_search(str, what, t));
+    BOOST_CHECK_EQUAL(what.position(), 4);
+    BOOST_CHECK(!regex_search(str, what, x));
+
+    // partial matches
+    BOOST_REQUIRE(regex_search(str, what, sregex::compile("e\\d"), regex_constants::match_partial));
+    BOOST_CHECK(!what[0].matched);
+    BOOST_CHECK_EQUAL(what[0].first - str.begin(), 12);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// init_unit_test_suite
+//
+test_suite* init_unit_test_suite( int argc, char* argv[] )
+{
+    test_suite *test = BOOST_TEST_SUITE("test searching contiguous sequences");
+    test->add(BOOST_TEST_CASE(&test_leading_char));
+    return test;
+}
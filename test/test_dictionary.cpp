@@ -0,0 +1,143 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_dictionary.cpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+//  Test replacing the keys of a map with their values.
+
+#include <map>
+#include <list>
+#include <string>
+#include <iterator>
+#include <boost/xpressive/xpressive.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::unit_test;
+using namespace boost::xpressive;
+
+typedef std::map<std::string, std::string> string_map;
+
+///////////////////////////////////////////////////////////////////////////////
+// naive_replace
+//   replace the longest key at each position, the slow way
+std::string naive_replace(std::string const &str, string_map const &map)
+{
+    std::string result;
+    for(std::size_t pos = 0; pos < str.size();)
+    {
+        string_map::const_iterator longest = map.end();
+        for(string_map::const_iterator it = map.begin(); it != map.end(); ++it)
+        {
+            if(!it->first.empty() && 0 == str.compare(pos, it->first.size(), it->first) &&
+               (longest == map.end() || it->first.size() > longest->first.size()))
+            {
+                longest = it;
+            }
+        }
+
+        if(longest == map.end())
+        {
+            result += str[pos++];
+        }
+        else
+        {
+            result += longest->second;
+            pos += longest->first.size();
+        }
+    }
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_longest
+void test_longest()
+{
+    string_map map;
+    map["foo"] = "1";
+    map["foobar"] = "2";
+    map["foob"] = "3";
+    map["bar"] = "4";
+    map["o"] = "5";
+    map["ba"] = "";
+    map[""] = "never";
+    dictionary<string_map> dict(map);
+
+    char const *strs[] =
+    {
+        ""
+      , "xyz"
+      , "foo"
+      , "foobar"
+      , "foobaz"
+      , "fofoobarfoob bar baz"
+      , "oooo"
+      , "fo"
+      , "barfoobarbarfo"
+    };
+
+    for(std::size_t i = 0; i < sizeof(strs) / sizeof(*strs); ++i)
+    {
+        BOOST_CHECK_EQUAL(dict.replace(strs[i]), naive_replace(strs[i], map));
+        BOOST_CHECK_EQUAL(dict.replace(std::string(strs[i])), naive_replace(strs[i], map));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_flags
+void test_flags()
+{
+    string_map map;
+    map["cat"] = "dog";
+    map["mouse"] = "cheese";
+    std::string str("The Cat chased the mouse, and the cat won.");
+
+    dictionary<string_map> dict(map), idict(map, regex_constants::icase);
+    BOOST_CHECK_EQUAL(dict.replace(str), "The Cat chased the cheese, and the dog won.");
+    BOOST_CHECK_EQUAL(idict.replace(str), "The dog chased the cheese, and the dog won.");
+    BOOST_CHECK_EQUAL(dict.replace(str, regex_constants::format_first_only), "The Cat chased the cheese, and the cat won.");
+    BOOST_CHECK_EQUAL(idict.replace(str, regex_constants::format_no_copy), "dogcheesedog");
+
+    // copies share the map
+    dictionary<string_map> copy(idict);
+    map.clear();
+    BOOST_CHECK_EQUAL(copy.replace(str, regex_constants::format_no_copy), "dogcheesedog");
+    BOOST_CHECK_EQUAL(dictionary<string_map>(map).replace(str), str);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_other_iterators
+void test_other_iterators()
+{
+    string_map map;
+    map["ab"] = "x";
+    map["abc"] = "y";
+    dictionary<string_map> dict(map);
+
+    std::string str("abcab ab abd");
+    std::list<char> const lst(str.begin(), str.end());
+    std::string out;
+    dict.replace(std::back_inserter(out), lst.begin(), lst.end());
+    BOOST_CHECK_EQUAL(out, "yx x xd");
+
+#ifndef BOOST_XPRESSIVE_NO_WREGEX
+    std::map<std::wstring, std::wstring> wmap;
+    wmap[L"ab"] = L"x";
+    wmap[L"abc"] = L"y";
+    dictionary<std::map<std::wstring, std::wstring> > wdict(wmap);
+    BOOST_CHECK(wdict.replace(L"abcab ab abd") == L"yx x xd");
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// init_unit_test_suite
+//
+test_suite* init_unit_test_suite( int argc, char* argv[] )
+{
+    test_suite *test = BOOST_TEST_SUITE("test dictionary replace");
+    test->add(BOOST_TEST_CASE(&test_longest));
+    test->add(BOOST_TEST_CASE(&test_flags));
+    test->add(BOOST_TEST_CASE(&test_other_iterators));
+    return test;
+}
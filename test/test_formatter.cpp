@@ -0,0 +1,162 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_formatter.cpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+//  Test that format strings parsed ahead of time give the same results.
+
+#include <string>
+#include <iterator>
+#include <boost/xpressive/xpressive.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::unit_test;
+using namespace boost::xpressive;
+
+///////////////////////////////////////////////////////////////////////////////
+// check_format
+//   replace rx in str with fmt as a string and as a formatter, and compare
+void check_format(std::string const &str, sregex const &rx, std::string const &fmt, regex_constants::match_flag_type flags)
+{
+    std::string expected = regex_replace(str, rx, fmt, flags);
+    sformatter formatter(rx, fmt, flags);
+    BOOST_CHECK_EQUAL(regex_replace(str, rx, formatter, flags), expected);
+    BOOST_CHECK_EQUAL(formatter.str(), fmt);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_dialects
+void test_dialects()
+{
+    std::string str("John Smith, Jane Doe, Mr. X; and ABC.");
+    sregex rx = sregex::compile("(?P<first>\\w+)(?: (?P<last>\\w+))?(\\.)?");
+
+    char const *formats[] =
+    {
+        ""
+      , "plain text"
+      , "$2, $1"
+      , "[$&]"
+      , "<$`|$'>"
+      , "$$1 $ $x $"
+      , "$12 $10 $03 $0x"
+      , "& \\& \\1 \\0 \\2\\3"
+      , "\\U$1\\E-\\l$2-\\u\\Lfoo $2 bar\\E baz"
+      , "\\g<last>, \\g<first>"
+      , "\\x41\\x{0042}\\cA\\n\\t\\e\\q\\"
+      , "(?2$2, :)$1"
+      , "?2(<$2>:no last) done"
+      , "((?3\\.:)x)(y)"
+      , "?3dot:(?2:no last)"
+      , "?1a:b:c"
+      , "\\(\\)\\:\\?"
+    };
+
+    regex_constants::match_flag_type flags[] =
+    {
+        regex_constants::format_default
+      , regex_constants::format_sed
+      , regex_constants::format_perl
+      , regex_constants::format_all
+      , regex_constants::format_literal
+      , regex_constants::format_perl | regex_constants::format_first_only
+    };
+
+    for(std::size_t i = 0; i < sizeof(formats) / sizeof(*formats); ++i)
+    {
+        for(std::size_t j = 0; j < sizeof(flags) / sizeof(*flags); ++j)
+        {
+            bool valid = true;
+            try
+            {
+                regex_replace(str, rx, std::string(formats[i]), flags[j]);
+            }
+            catch(regex_error const &)
+            {
+                valid = false;
+            }
+
+            if(valid)
+            {
+                check_format(str, rx, formats[i], flags[j]);
+            }
+            else
+            {
+                BOOST_CHECK_THROW(sformatter(rx, formats[i], flags[j]), regex_error);
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_errors
+//   errors are found when the formatter is constructed
+void test_errors()
+{
+    sregex rx = sregex::compile("(\\w)(\\w)");
+    BOOST_CHECK_THROW(sformatter(rx, "$0"), regex_error);
+    BOOST_CHECK_THROW(sformatter(rx, "\\g<a>", regex_constants::format_perl), regex_error);
+    BOOST_CHECK_THROW(sformatter(rx, "\\xZZ", regex_constants::format_perl), regex_error);
+    BOOST_CHECK_THROW(sformatter(rx, "(x", regex_constants::format_all), regex_error);
+    BOOST_CHECK_THROW(sformatter(rx, "?9x", regex_constants::format_all), regex_error);
+    BOOST_CHECK_NO_THROW(sformatter(rx, "?9x"));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_other_results
+//   results of another regex are formatted from the string
+void test_other_results()
+{
+    std::string str("ab cd");
+    sregex one = sregex::compile("(\\w)"), two = sregex::compile("(\\w)(\\w)");
+    sformatter formatter(two, "[$2$1]");
+
+    smatch what;
+    BOOST_REQUIRE(regex_search(str, what, two));
+    std::string out;
+    what.format(std::back_inserter(out), formatter);
+    BOOST_CHECK_EQUAL(out, "[ba]");
+    BOOST_CHECK_EQUAL(what.format(formatter), "[ba]");
+
+    // $2 is not a valid back-reference for one
+    BOOST_REQUIRE(regex_search(str, what, one));
+    BOOST_CHECK_THROW(what.format(formatter), regex_error);
+    BOOST_CHECK_EQUAL(what.format(sformatter(one, "[$1]")), "[a]");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_other_iterators
+void test_other_iterators()
+{
+    char const *str = "key=value";
+    cregex rx = cregex::compile("(\\w+)=(\\w+)");
+    cformatter formatter(rx, "\\u$2=\\U$1", regex_constants::format_perl);
+    BOOST_CHECK_EQUAL(regex_replace(str, rx, formatter), "Value=KEY");
+
+#ifndef BOOST_XPRESSIVE_NO_WREGEX
+    std::wstring wstr(L"key=value");
+    wsregex wrx = wsregex::compile(L"(?P<k>\\w+)=(?P<v>\\w+)");
+    wsformatter wformatter(wrx, L"\\g<v>=\\g<k>", regex_constants::format_perl);
+    BOOST_CHECK(regex_replace(wstr, wrx, wformatter) == L"value=key");
+#endif
+
+    // static regexes
+    std::string sstr("aaa bbb");
+    sregex srx = (s1= +_w) >> ' ' >> (s2= +_w);
+    BOOST_CHECK_EQUAL(regex_replace(sstr, srx, sformatter(srx, "$2 $1")), "bbb aaa");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// init_unit_test_suite
+//
+test_suite* init_unit_test_suite( int argc, char* argv[] )
+{
+    test_suite *test = BOOST_TEST_SUITE("test formatters parsed ahead of time");
+    test->add(BOOST_TEST_CASE(&test_dialects));
+    test->add(BOOST_TEST_CASE(&test_errors));
+    test->add(BOOST_TEST_CASE(&test_other_results));
+    test->add(BOOST_TEST_CASE(&test_other_iterators));
+    return test;
+}
@@ -0,0 +1,203 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_literal_alternates.cpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+//  Test that long alternations of literals, which dynamic regexes match with a
+//  trie, match what they would if each alternate were tried in turn.
+
+#include <string>
+#include <vector>
+#include <boost/xpressive/xpressive_dynamic.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::unit_test;
+using namespace boost::xpressive;
+
+///////////////////////////////////////////////////////////////////////////////
+// alternates
+//   join the words with |, and if grouped, put each one in a group of its own
+//   so that the alternates are tried in turn
+std::string alternates(std::vector<std::string> const &words, bool grouped)
+{
+    std::string str;
+    for(std::size_t i = 0; i < words.size(); ++i)
+    {
+        str += (0 == i ? "" : "|");
+        str += grouped ? "(?:" + words[i] + ")" : words[i];
+    }
+    return str;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// check_same
+//   the pattern, with the alternates of words in place of %, finds the same
+//   matches whether or not the alternates are grouped
+void check_same(std::string const &pattern, std::vector<std::string> const &words, std::string const &str, regex_constants::syntax_option_type flags = regex_constants::ECMAScript)
+{
+    std::string::size_type pos = pattern.find('%');
+    std::string const trie = std::string(pattern).replace(pos, 1, alternates(words, false));
+    std::string const each = std::string(pattern).replace(pos, 1, alternates(words, true));
+    sregex const rx1 = sregex::compile(trie, flags);
+    sregex const rx2 = sregex::compile(each, flags);
+
+    sregex_iterator cur1(str.begin(), str.end(), rx1), cur2(str.begin(), str.end(), rx2), end;
+    for(; cur1 != end && cur2 != end; ++cur1, ++cur2)
+    {
+        if(cur1->position() != cur2->position() || cur1->str() != cur2->str() || cur1->size() != cur2->size())
+        {
+            BOOST_ERROR(pattern << ": found \"" << cur1->str() << "\" at " << cur1->position()
+                << ", expected \"" << cur2->str() << "\" at " << cur2->position());
+            return;
+        }
+        for(std::size_t i = 1; i < cur1->size(); ++i)
+        {
+            BOOST_CHECK_EQUAL((*cur1)[i].str(), (*cur2)[i].str());
+        }
+    }
+    BOOST_CHECK_MESSAGE(cur1 == end && cur2 == end, pattern << ": found a different number of matches");
+}
+
+std::vector<std::string> split(std::string const &str)
+{
+    std::vector<std::string> words;
+    for(std::string::size_type begin = 0, end = 0; std::string::npos != end; begin = end + 1)
+    {
+        end = str.find(' ', begin);
+        words.push_back(str.substr(begin, end - begin));
+    }
+    return words;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_first_wins
+//   the alternate written first wins, not the longest
+void test_first_wins()
+{
+    std::vector<std::string> const words = split("a ab abc b bc bcd cd dcba xyz ab abcd e f g h i j k");
+    std::string const str("abcd dcba abcdx xyz bcd abc ab a");
+
+    check_same("%", words, str);
+    check_same("(%)", words, str);
+    check_same("(?:%)d", words, str);
+    check_same("(%)\\b", words, str);
+    check_same("(?:%)(?:cd|d)?x", words, str);
+    check_same("\\b(?:%)\\b", words, str);
+    check_same("(?:%)+", words, str);
+    check_same("(?:%){2}", words, str);
+
+    // a longer alternate written first is found before a shorter one
+    sregex rx = sregex::compile("ab|abcd|a|b|c|d|e|f|g|h|i|j|k|l|m|n");
+    smatch what;
+    std::string const abcd("abcd"), abc("abc");
+    BOOST_REQUIRE(regex_search(abcd, what, rx));
+    BOOST_CHECK_EQUAL(what[0].str(), "ab");
+    rx = sregex::compile("(?:abcd|ab|a|b|c|d|e|f|g|h|i|j|k|l|m|n)$");
+    BOOST_REQUIRE(regex_search(abc, what, rx));
+    BOOST_CHECK_EQUAL(what[0].str(), "c");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_mixed
+//   alternates that aren't literals keep their place among those that are
+void test_mixed()
+{
+    std::vector<std::string> const words = split("one two three four five six seven eight nine ten eleven twelve thirteen "
+        "fourteen fifteen sixteen t\\w+ on(e)? \\d+ seventeen eighteen nineteen twenty "
+        "twenty-one twenty-two twenty-three twenty-four twenty-five twenty-six tw\\x65lve "
+        "twenty-seven oneone");
+    std::string const str("one twenty-one twelve 42 seventeen thirteen ten tens nine0 oneone twenty-six");
+
+    check_same("%", words, str);
+    check_same("(%)", words, str);
+    check_same("\\b(?:%)\\b", words, str);
+    check_same("(?:%)s", words, str);
+    check_same("(%)+e", words, str);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_flags
+void test_flags()
+{
+    std::vector<std::string> const words = split("Alpha beta GAMMA delta Epsilon zeta eta theta iota kappa Lambda mu nu xi omicron pi");
+    std::string const str("ALPHA Beta gamma DELTA epsilon Zeta theta alpha");
+
+    check_same("\\b(?:%)\\b", words, str);
+    check_same("\\b(?:%)\\b", words, str, regex_constants::icase);
+    check_same("(?i:%)", words, str);
+    check_same("(?i)(%)", words, str);
+    check_same("(?x) \\b (?: % ) \\b # comment", words, str);
+
+    // under (?x), white space inside the alternates is ignored
+    sregex rx = sregex::compile("(?x) a b | c d | e f | g h | i j | k l | m n | o p | q r | s t | u v | w x | y z | 1 2 | 3 4 | 5 6");
+    BOOST_CHECK(regex_match(std::string("kl"), rx));
+    BOOST_CHECK(!regex_match(std::string("k l"), rx));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_width
+//   alternates of the same length can be looked behind
+void test_width()
+{
+    std::vector<std::string> const words = split("cat dog cow pig hen fox owl ant bee elk emu yak gnu ram ewe cod");
+    std::string const str("a cat, a dog, a big pig and an owl, but not a catfish");
+
+    check_same("(?<=%) ", words, str);
+    check_same("(?<!%)[a-z]+", words, str);
+    check_same("(?:%){1,2}", words, str);
+    check_same("(?:%)*?,", words, str);
+
+    std::vector<std::string> const mixed = split("cat dog cow pig hen fox owl ant bee elk emu yak gnu ram ewe cod horse");
+    BOOST_CHECK_THROW(sregex::compile("(?<=" + alternates(mixed, false) + ")"), regex_error);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_many
+//   a few thousand alternates, like those made from a word list
+void test_many()
+{
+    std::vector<std::string> words;
+    std::string str;
+    for(int i = 1; i < 3000; ++i)
+    {
+        std::string word;
+        for(int j = i * 7919 % 3001; 0 != j; j /= 26)
+        {
+            word += char('a' + j % 26);
+        }
+        words.push_back(word);
+        if(0 == i % 97)
+        {
+            str += word + "s " + word + " x" + word + " ";
+        }
+    }
+
+    check_same("\\b(?:%)\\b", words, str);
+    check_same("(%)", words, str);
+    check_same("\\b(?:%)s\\b", words, str);
+
+    sregex const rx = sregex::compile("\\b(?:" + alternates(words, false) + ")\\b");
+    for(std::size_t i = 0; i < words.size(); ++i)
+    {
+        if(!regex_match(words[i], rx))
+        {
+            BOOST_ERROR("word not found: " << words[i]);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// init_unit_test_suite
+//
+test_suite* init_unit_test_suite( int argc, char* argv[] )
+{
+    test_suite *test = BOOST_TEST_SUITE("test long alternations of literals");
+    test->add(BOOST_TEST_CASE(&test_first_wins));
+    test->add(BOOST_TEST_CASE(&test_mixed));
+    test->add(BOOST_TEST_CASE(&test_flags));
+    test->add(BOOST_TEST_CASE(&test_width));
+    test->add(BOOST_TEST_CASE(&test_many));
+    return test;
+}
@@ -0,0 +1,170 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_literal_replace.cpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+//  Test that replacing a regex that is nothing but a string gives the same
+//  results as replacing an equivalent regex that isn't.
+
+#include <list>
+#include <string>
+#include <iterator>
+#include <boost/xpressive/xpressive.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::unit_test;
+using namespace boost::xpressive;
+
+///////////////////////////////////////////////////////////////////////////////
+// check_replace
+//   replace rx in str with fmt, and compare with replacing ref
+void check_replace(std::string const &str, sregex const &rx, sregex const &ref, std::string const &fmt, regex_constants::match_flag_type flags)
+{
+    std::string const expected = regex_replace(str, ref, fmt, flags);
+    BOOST_CHECK_EQUAL(regex_replace(str, rx, fmt, flags), expected);
+    BOOST_CHECK_EQUAL(regex_replace(str, rx, fmt.c_str(), flags), regex_replace(str, ref, fmt.c_str(), flags));
+
+    std::string out;
+    regex_replace(std::back_inserter(out), str.begin(), str.end(), rx, fmt, flags);
+    BOOST_CHECK_EQUAL(out, expected);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_dynamic
+void test_dynamic()
+{
+    char const *patterns[] = {"foo", "a", "aa", "a\\.b", "ab*", "a|b", "x{2}", "\\x41B", "A"};
+    std::string const strs[] =
+    {
+        ""
+      , "nothing here"
+      , "foo"
+      , "foofoo and foo, then fo"
+      , "aaaaa"
+      , "a.b a.b axb"
+      , "ABBA xx xxx abba"
+      , std::string("nul\0foo\0a", 9)
+    };
+    std::string const formats[] =
+    {
+        ""
+      , "bar"
+      , "[$&]"
+      , "<$`|$'>"
+      , "& \\0"
+      , "(?1x:y)"
+      , "\\Ubar"
+      , std::string("b\0r", 3)
+    };
+    regex_constants::match_flag_type flags[] =
+    {
+        regex_constants::format_default
+      , regex_constants::format_sed
+      , regex_constants::format_perl
+      , regex_constants::format_all
+      , regex_constants::format_literal
+      , regex_constants::format_no_copy
+      , regex_constants::format_first_only
+      , regex_constants::format_perl | regex_constants::format_no_copy | regex_constants::format_first_only
+      , regex_constants::match_not_bol | regex_constants::match_not_bow
+      , regex_constants::match_continuous
+    };
+
+    for(std::size_t p = 0; p < sizeof(patterns) / sizeof(*patterns); ++p)
+    {
+        sregex rx = sregex::compile(patterns[p]);
+        sregex ref = sregex::compile(std::string("(?:") + patterns[p] + ")");
+        for(std::size_t s = 0; s < sizeof(strs) / sizeof(*strs); ++s)
+        {
+            for(std::size_t f = 0; f < sizeof(formats) / sizeof(*formats); ++f)
+            {
+                for(std::size_t g = 0; g < sizeof(flags) / sizeof(*flags); ++g)
+                {
+                    bool valid = true;
+                    try
+                    {
+                        regex_replace(strs[s], ref, formats[f], flags[g]);
+                    }
+                    catch(regex_error const &)
+                    {
+                        valid = false;
+                    }
+
+                    if(valid)
+                    {
+                        check_replace(strs[s], rx, ref, formats[f], flags[g]);
+                    }
+                    else
+                    {
+                        BOOST_CHECK_THROW(regex_replace(strs[s], rx, formats[f], flags[g]), regex_error);
+                    }
+                }
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_syntax
+//   patterns that look like strings, but aren't
+void test_syntax()
+{
+    std::string str("Foo foo FOO f o o");
+    BOOST_CHECK_EQUAL(regex_replace(str, sregex::compile("foo", regex_constants::icase), "x"), "x x x f o o");
+    BOOST_CHECK_EQUAL(regex_replace(str, sregex::compile("f o o", regex_constants::ignore_white_space), "x"), "Foo x FOO f o o");
+    BOOST_CHECK_EQUAL(regex_replace(str, sregex::compile("f o o"), "x"), "Foo foo FOO x");
+    BOOST_CHECK_EQUAL(regex_replace(str, sregex::compile("fo+"), "x"), "Foo x FOO f o o");
+
+    // a named rule that is compiled again forgets that it was a string
+    sregex_compiler compiler;
+    compiler.compile("(?$rule=)foo");
+    BOOST_CHECK_EQUAL(regex_replace(str, compiler["rule"], "x"), "Foo x FOO f o o");
+    compiler.compile("(?$rule=)o+");
+    BOOST_CHECK_EQUAL(regex_replace(str, compiler["rule"], "x"), "Fx fx FOO f x x");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_other_iterators
+void test_other_iterators()
+{
+    // static regexes
+    std::string str("foo bar foo");
+    sregex foo = as_xpr("foo"), o = as_xpr('o');
+    BOOST_CHECK_EQUAL(regex_replace(str, foo, "baz"), "baz bar baz");
+    BOOST_CHECK_EQUAL(regex_replace(str, o, "0"), "f00 bar f00");
+    BOOST_CHECK_EQUAL(regex_replace(str, foo, "[$&]"), "[foo] bar [foo]");
+
+    // null-terminated strings
+    char const *cstr = "foo bar foo";
+    cregex crx = cregex::compile("bar");
+    BOOST_CHECK_EQUAL(regex_replace(cstr, crx, "baz"), "foo baz foo");
+    BOOST_CHECK_EQUAL(regex_replace(cstr, crx, std::string("baz")), "foo baz foo");
+
+    // iterators that aren't contiguous
+    typedef std::list<char>::const_iterator list_iter;
+    std::list<char> const lst(str.begin(), str.end());
+    basic_regex<list_iter> lrx = basic_regex<list_iter>::compile("foo");
+    std::string out;
+    regex_replace(std::back_inserter(out), lst.begin(), lst.end(), lrx, "baz");
+    BOOST_CHECK_EQUAL(out, "baz bar baz");
+
+#ifndef BOOST_XPRESSIVE_NO_WREGEX
+    std::wstring wstr(L"foo bar foo");
+    wsregex wrx = wsregex::compile(L"foo");
+    BOOST_CHECK(regex_replace(wstr, wrx, L"baz") == L"baz bar baz");
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// init_unit_test_suite
+//
+test_suite* init_unit_test_suite( int argc, char* argv[] )
+{
+    test_suite *test = BOOST_TEST_SUITE("test replacing regexes that are strings");
+    test->add(BOOST_TEST_CASE(&test_dynamic));
+    test->add(BOOST_TEST_CASE(&test_syntax));
+    test->add(BOOST_TEST_CASE(&test_other_iterators));
+    return test;
+}
@@ -0,0 +1,192 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_mapped_symbols.cpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+//  Test that symbol tables searched in an image made ahead of time find the
+//  same keys as the maps they were made from.
+
+#include <map>
+#include <string>
+#include <vector>
+#include <iterator>
+#include <boost/cstdint.hpp>
+#include <boost/xpressive/xpressive_static.hpp>
+#include <boost/xpressive/regex_actions.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::unit_test;
+using namespace boost::xpressive;
+
+typedef std::map<std::string, boost::uint32_t> id_map;
+typedef mapped_symbols<char> mapped_type;
+
+///////////////////////////////////////////////////////////////////////////////
+// make_image
+//   write an image of map into memory that is suitably aligned
+std::vector<double> make_image(id_map const &map, regex_constants::syntax_option_type flags = regex_constants::ECMAScript)
+{
+    std::vector<char> bytes;
+    mapped_type::write(std::back_inserter(bytes), map, flags);
+    std::vector<double> image((bytes.size() + sizeof(double) - 1) / sizeof(double));
+    std::copy(bytes.begin(), bytes.end(), reinterpret_cast<char *>(&image[0]));
+    return image;
+}
+
+std::size_t image_size(id_map const &map)
+{
+    std::vector<char> bytes;
+    mapped_type::write(std::back_inserter(bytes), map);
+    return bytes.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_same_as_map
+void test_same_as_map()
+{
+    id_map map;
+    map["foo"] = 1;
+    map["foobar"] = 2;
+    map["bar"] = 3;
+    map["\xE9t\xE9"] = 4;
+    map["a"] = 5;
+    for(boost::uint32_t i = 0; i < 1000; ++i)
+    {
+        std::string key("k");
+        for(boost::uint32_t j = i; j != 0; j /= 7)
+        {
+            key += char('0' + j % 7);
+        }
+        map[key] = 100 + i;
+    }
+
+    std::vector<double> const image = make_image(map);
+    mapped_type const sym(&image[0], image_size(map));
+    BOOST_CHECK_EQUAL(sym.size(), map.size());
+
+    boost::uint32_t result = 0;
+    sregex rx = (a1=sym)[ boost::xpressive::ref(result) = a1 ];
+    for(id_map::const_iterator it = map.begin(); it != map.end(); ++it)
+    {
+        if(!regex_match(it->first, rx) || result != it->second)
+        {
+            BOOST_ERROR("key not found: " << it->first);
+        }
+    }
+    BOOST_CHECK(!regex_match(std::string("fo"), rx));
+    BOOST_CHECK(!regex_match(std::string("foob"), rx));
+    BOOST_CHECK(!regex_match(std::string("k7"), rx));
+
+    // searching finds the same keys as the map does
+    boost::uint32_t expected = 0;
+    sregex mrx = (a1=map)[ boost::xpressive::ref(expected) = a1 ];
+    std::string const str("xx foobaz k123 zz \xE9t\xE9 bar");
+    sregex_iterator cur(str.begin(), str.end(), rx), end;
+    sregex_iterator mcur(str.begin(), str.end(), mrx);
+    for(; cur != end && mcur != end; ++cur, ++mcur)
+    {
+        BOOST_CHECK_EQUAL(cur->position(), mcur->position());
+        BOOST_CHECK_EQUAL(cur->str(), mcur->str());
+        BOOST_CHECK_EQUAL(result, expected);
+    }
+    BOOST_CHECK(cur == end && mcur == end);
+
+    // the table can be used directly
+    std::string::const_iterator begin = str.begin() + 3;
+    boost::uint32_t const *value = sym.find(begin, str.end());
+    BOOST_REQUIRE(value);
+    BOOST_CHECK_EQUAL(*value, 1u);
+    BOOST_CHECK(begin == str.begin() + 6);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_icase
+void test_icase()
+{
+    id_map map;
+    map["One"] = 1;
+    map["two"] = 2;
+
+    std::vector<double> const image = make_image(map, regex_constants::icase);
+    mapped_type const sym(&image[0], image.size() * sizeof(double));
+
+    boost::uint32_t result = 0;
+    sregex rx = (a1=sym)[ boost::xpressive::ref(result) = a1 ];
+    BOOST_CHECK(regex_search(std::string("... oNE"), rx));
+    BOOST_CHECK_EQUAL(result, 1u);
+    BOOST_CHECK(regex_search(std::string("TWO ..."), rx));
+    BOOST_CHECK_EQUAL(result, 2u);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_bad_images
+void test_bad_images()
+{
+    id_map map;
+    map["foo"] = 1;
+    map["bar"] = 2;
+    std::vector<double> image = make_image(map);
+    std::size_t const size = image_size(map);
+    BOOST_CHECK_NO_THROW(mapped_type(&image[0], size));
+
+    // too short, misaligned, or for another value type
+    BOOST_CHECK_THROW(mapped_type(&image[0], size - 1), regex_error);
+    BOOST_CHECK_THROW(mapped_type(0, size), regex_error);
+    BOOST_CHECK_THROW(mapped_type(reinterpret_cast<char const *>(&image[0]) + 1, size), regex_error);
+    BOOST_CHECK_THROW((mapped_symbols<char, boost::uint64_t>(&image[0], size)), regex_error);
+    BOOST_CHECK_THROW((mapped_symbols<wchar_t>(&image[0], size)), regex_error);
+
+    // links that go backward end the search
+    boost::uint32_t *words = reinterpret_cast<boost::uint32_t *>(&image[0]);
+    for(std::size_t i = 16; i < size / 4; ++i)
+    {
+        words[i] = 1;
+    }
+    mapped_type const sym(&image[0], size);
+    std::string const str("foo");
+    std::string::const_iterator begin = str.begin();
+    sym.find(begin, str.end());
+
+    // a table with no keys finds nothing
+    mapped_type const empty;
+    begin = str.begin();
+    BOOST_CHECK(0 == empty.find(begin, str.end()));
+    BOOST_CHECK_EQUAL(empty.size(), 0u);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_wide
+void test_wide()
+{
+#ifndef BOOST_XPRESSIVE_NO_WREGEX
+    std::map<std::wstring, int> map;
+    map[L"alpha"] = 1;
+    map[L"beta"] = 2;
+
+    std::vector<char> bytes;
+    mapped_symbols<wchar_t, int>::write(std::back_inserter(bytes), map);
+    std::vector<double> image((bytes.size() + sizeof(double) - 1) / sizeof(double));
+    std::copy(bytes.begin(), bytes.end(), reinterpret_cast<char *>(&image[0]));
+    mapped_symbols<wchar_t, int> const sym(&image[0], bytes.size());
+
+    int result = 0;
+    wsregex rx = (a1=sym)[ boost::xpressive::ref(result) = a1 ];
+    BOOST_CHECK(regex_match(std::wstring(L"beta"), rx));
+    BOOST_CHECK_EQUAL(result, 2);
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// init_unit_test_suite
+//
+test_suite* init_unit_test_suite( int argc, char* argv[] )
+{
+    test_suite *test = BOOST_TEST_SUITE("test symbol tables searched in place");
+    test->add(BOOST_TEST_CASE(&test_same_as_map));
+    test->add(BOOST_TEST_CASE(&test_icase));
+    test->add(BOOST_TEST_CASE(&test_bad_images));
+    test->add(BOOST_TEST_CASE(&test_wide));
+    return test;
+}
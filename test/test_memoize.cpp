@@ -0,0 +1,186 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_memoize.cpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+//  Test that match_memoize doesn't change the results of a match.
+
+#include <list>
+#include <string>
+#include <boost/xpressive/xpressive.hpp>
+#include <boost/xpressive/regex_actions.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::unit_test;
+using namespace boost::xpressive;
+namespace xp = boost::xpressive;
+
+///////////////////////////////////////////////////////////////////////////////
+// check_memoize
+//   search str for rx with and without match_memoize, and compare the results
+template<typename BidiIter>
+void check_memoize(BidiIter begin, BidiIter end, basic_regex<BidiIter> const &rx, std::size_t max_bytes = 0)
+{
+    match_results<BidiIter> expected, actual;
+    if(0 != max_bytes)
+    {
+        actual.max_retained_bytes(max_bytes);
+    }
+
+    bool const found = regex_search(begin, end, expected, rx);
+    BOOST_REQUIRE_EQUAL(regex_search(begin, end, actual, rx, regex_constants::match_memoize), found);
+    if(found)
+    {
+        BOOST_CHECK_EQUAL(actual.position(), expected.position());
+        BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+        for(std::size_t i = 0; i < expected.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL(actual[i].matched, expected[i].matched);
+            BOOST_CHECK(actual[i] == expected[i]);
+        }
+        BOOST_CHECK_EQUAL(actual.nested_results().size(), expected.nested_results().size());
+    }
+}
+
+void check_memoize(std::string const &str, sregex const &rx, std::size_t max_bytes = 0)
+{
+    check_memoize(str.begin(), str.end(), rx, max_bytes);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_static
+void test_static()
+{
+    sregex a, b, la, lb;
+    a = ('x' >> by_ref(a)) | ('x' >> by_ref(b)) | 'x';
+    b = ('x' >> by_ref(a)) | 'x';
+    la = ('x' >> nosubs(by_ref(la))) | ('x' >> nosubs(by_ref(lb))) | 'x';
+    lb = ('x' >> nosubs(by_ref(la))) | 'x';
+
+    sregex tops[] =
+    {
+        a >> '!'
+      , (s1= a) >> (s2= b) >> '!'
+      , nosubs(la) >> '!'
+      , (s1= nosubs(la)) >> nosubs(lb) >> '?'
+      , *(nosubs(lb) >> '-') >> nosubs(la)
+    };
+
+    char const *strs[] = {"", "x", "xx!", "xxxxx!", "xx-xxx-x", "x-x?", "xxxxxxxx?"};
+    for(std::size_t i = 0; i < sizeof(tops) / sizeof(*tops); ++i)
+    {
+        for(std::size_t j = 0; j < sizeof(strs) / sizeof(*strs); ++j)
+        {
+            check_memoize(strs[j], tops[i]);
+            check_memoize(strs[j], tops[i], 256);
+        }
+    }
+
+    // exponential without match_memoize, and still correct with it
+    smatch what;
+    sregex bang = nosubs(la) >> '!';
+    std::string str(20, 'x');
+    BOOST_CHECK(!regex_search(str, what, bang, regex_constants::match_memoize));
+    str += '!';
+    BOOST_REQUIRE(regex_search(str, what, bang, regex_constants::match_memoize));
+    BOOST_CHECK_EQUAL(what[0].length(), 21);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_actions
+void test_actions()
+{
+    std::string str("1+22+333;");
+    int sum = 0;
+    smatch what;
+
+    // nested regexes with actions are matched again, so the actions run
+    sregex number = (s1= +_d)[ xp::ref(sum) += as<int>(s1) ];
+    sregex expr = nosubs(number) >> *('+' >> nosubs(number)) >> ';';
+    BOOST_REQUIRE(regex_match(str, what, expr, regex_constants::match_memoize));
+    BOOST_CHECK_EQUAL(sum, 356);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_zero_width
+//   nested regexes that can end where they began, so that what follows them
+//   tries them again at the same position
+void test_zero_width()
+{
+    sregex as = *as_xpr('a');
+    sregex opt = !as_xpr('a');
+    sregex twice = nosubs(as) >> nosubs(as);
+
+    sregex tops[] =
+    {
+        nosubs(as) >> nosubs(as) >> 'x'
+      , nosubs(opt) >> nosubs(opt) >> nosubs(opt) >> '!'
+      , (s1= as) >> (s2= as) >> 'x'
+      , nosubs(twice) >> nosubs(twice) >> 'x'
+      , *(nosubs(opt) >> '-') >> nosubs(as) >> '!'
+      , nosubs(as) >> (nosubs(as) | 'b') >> nosubs(as) >> 'x'
+    };
+
+    char const *strs[] = {"", "b", "x", "aax", "aab", "a!", "aa!", "-a-!", "a-a-aa!", "bax", "aabaax"};
+    for(std::size_t i = 0; i < sizeof(tops) / sizeof(*tops); ++i)
+    {
+        for(std::size_t j = 0; j < sizeof(strs) / sizeof(*strs); ++j)
+        {
+            check_memoize(strs[j], tops[i]);
+            check_memoize(strs[j], tops[i], 256);
+        }
+    }
+
+    sregex dyn = sregex::compile("(?:a*)");
+    check_memoize("bbbx", nosubs(dyn) >> nosubs(dyn) >> 'x');
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_dynamic
+void test_dynamic()
+{
+    sregex_compiler compiler;
+    regex_constants::syntax_option_type x = regex_constants::ignore_white_space | regex_constants::nosubs;
+    compiler.compile( "(? $group  = ) \\( (? $expr ) \\) ", x);
+    compiler.compile( "(? $factor = ) \\d+ | (? $group ) ", x);
+    compiler.compile( "(? $term   = ) (? $factor ) (?: \\* (? $factor ) | / (? $factor ) )* ", x);
+    sregex expr = compiler.compile( "(? $expr   = ) (? $term )   (?: \\+ (? $term )   | - (? $term )   )* ", x);
+
+    check_memoize("foo 9*(10+3) bar", expr);
+    check_memoize("((((((1+2", expr);
+    check_memoize("1+(2*(3-4)/5)+(6", expr);
+
+    sregex parens = sregex::compile("\\((?:\\w|(?R))*\\)", regex_constants::nosubs);
+    check_memoize("(a(b)(c(d)))", parens);
+    check_memoize("((a(b)(c(d))", parens);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_list
+//   match_memoize has no effect with bidirectional iterators
+void test_list()
+{
+    typedef std::list<char>::const_iterator list_iter;
+    std::string str("xxxx!");
+    std::list<char> const lst(str.begin(), str.end());
+
+    basic_regex<list_iter> la;
+    la = ('x' >> nosubs(by_ref(la))) | 'x';
+    check_memoize(lst.begin(), lst.end(), basic_regex<list_iter>(nosubs(la) >> '!'));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// init_unit_test_suite
+//
+test_suite* init_unit_test_suite( int argc, char* argv[] )
+{
+    test_suite *test = BOOST_TEST_SUITE("test memoizing nested regexes");
+    test->add(BOOST_TEST_CASE(&test_static));
+    test->add(BOOST_TEST_CASE(&test_actions));
+    test->add(BOOST_TEST_CASE(&test_zero_width));
+    test->add(BOOST_TEST_CASE(&test_dynamic));
+    test->add(BOOST_TEST_CASE(&test_list));
+    return test;
+}
@@ -0,0 +1,157 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_move.cpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+//  Test moving regexes, results and iterators.
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <boost/config.hpp>
+#include <boost/xpressive/xpressive.hpp>
+#include <boost/test/unit_test.hpp>
+#ifndef BOOST_NO_CXX11_HDR_TYPE_TRAITS
+# include <type_traits>
+#endif
+
+using namespace boost::unit_test;
+using namespace boost::xpressive;
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+
+#ifndef BOOST_NO_CXX11_HDR_TYPE_TRAITS
+static_assert(std::is_nothrow_move_constructible<sregex>::value, "sregex");
+static_assert(std::is_nothrow_move_constructible<smatch>::value, "smatch");
+static_assert(std::is_nothrow_move_assignable<smatch>::value, "smatch");
+static_assert(std::is_nothrow_move_constructible<ssub_match>::value, "ssub_match");
+static_assert(std::is_nothrow_move_constructible<sregex_iterator>::value, "sregex_iterator");
+static_assert(std::is_nothrow_move_assignable<sregex_iterator>::value, "sregex_iterator");
+static_assert(std::is_nothrow_move_constructible<sregex_token_iterator>::value, "sregex_token_iterator");
+static_assert(std::is_nothrow_move_assignable<sregex_token_iterator>::value, "sregex_token_iterator");
+#endif
+
+smatch find_pairs(std::string const &str)
+{
+    sregex pair = (s1= +_w) >> '=' >> (s2= +_d);
+    sregex pairs = pair >> *(',' >> pair);
+    smatch what;
+    regex_match(str, what, pairs);
+    return what;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_move_results
+void test_move_results()
+{
+    std::string str("a=1,bb=22,ccc=333");
+    smatch what(find_pairs(str));
+    BOOST_REQUIRE(what);
+    BOOST_CHECK_EQUAL(what.nested_results().size(), 3u);
+    BOOST_CHECK_EQUAL(what.nested_results().back()[1].str(), "ccc");
+
+    smatch moved(std::move(what));
+    BOOST_CHECK_EQUAL(what.size(), 0u);
+    BOOST_CHECK_EQUAL(what.nested_results().size(), 0u);
+    BOOST_CHECK_EQUAL(moved.nested_results().size(), 3u);
+    BOOST_CHECK_EQUAL(moved[0].str(), str);
+
+    std::string str1("x=0"), str2("y=5,z=6");
+    std::vector<smatch> all;
+    all.push_back(std::move(moved));
+    all.push_back(find_pairs(str1));
+    all.push_back(find_pairs(str2));
+    BOOST_CHECK_EQUAL(all[0].nested_results().front()[1].str(), "a");
+    BOOST_CHECK_EQUAL(all[1].nested_results().front()[2].str(), "0");
+    BOOST_CHECK_EQUAL(all[2].nested_results().back()[1].str(), "z");
+
+    // the moved-from object can be reused
+    std::string str3("to eric@boost");
+    sregex rx = sregex::compile("(\\w+)@(\\w+)");
+    BOOST_REQUIRE(regex_search(str3, what, rx));
+    BOOST_CHECK_EQUAL(what[2].str(), "boost");
+
+    what = std::move(all[2]);
+    BOOST_CHECK_EQUAL(what.nested_results().size(), 2u);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_move_regex
+void test_move_regex()
+{
+    sregex rx = sregex::compile("b+");
+    regex_id_type id = rx.regex_id();
+
+    sregex moved(std::move(rx));
+    BOOST_CHECK(moved.regex_id() == id);
+    BOOST_CHECK(rx.regex_id() == 0);
+    BOOST_CHECK(regex_search(std::string("abbc"), moved));
+    BOOST_CHECK(!regex_search(std::string("abbc"), rx));
+
+    // a regex that embeds another by reference sees it through a move
+    sregex inner = as_xpr('x');
+    sregex outer = 'a' >> by_ref(inner) >> 'c';
+    BOOST_CHECK(regex_match(std::string("axc"), outer));
+
+    // inner is referenced, so assigning into it must update outer
+    inner = sregex::compile("y+");
+    BOOST_CHECK(regex_match(std::string("ayyc"), outer));
+    sregex other = as_xpr('z');
+    inner = std::move(other);
+    BOOST_CHECK(regex_match(std::string("azc"), outer));
+    BOOST_CHECK(!regex_match(std::string("ayyc"), outer));
+
+    sregex holder(std::move(inner));
+    BOOST_CHECK(regex_match(std::string("azc"), outer));
+    BOOST_CHECK(regex_match(std::string("z"), holder));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_move_iterators
+void test_move_iterators()
+{
+    std::string str("one two three");
+    sregex rx = +_w;
+
+    sregex_iterator cur(str.begin(), str.end(), rx), end;
+    sregex_iterator moved(std::move(cur));
+    BOOST_CHECK(cur == end);
+    BOOST_REQUIRE(moved != end);
+    BOOST_CHECK_EQUAL((*moved)[0].str(), "one");
+    ++moved;
+    BOOST_CHECK_EQUAL((*moved)[0].str(), "two");
+    cur = std::move(moved);
+    ++cur;
+    BOOST_CHECK_EQUAL((*cur)[0].str(), "three");
+    BOOST_CHECK(++cur == end);
+
+    sregex_token_iterator tok(str.begin(), str.end(), rx), tend;
+    std::vector<std::string> words;
+    for(sregex_token_iterator it(std::move(tok)); it != tend; ++it)
+        words.push_back(*it);
+    BOOST_CHECK(tok == tend);
+    BOOST_REQUIRE_EQUAL(words.size(), 3u);
+    BOOST_CHECK_EQUAL(words[2], "three");
+}
+
+#else
+
+void test_move_results() {}
+void test_move_regex() {}
+void test_move_iterators() {}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// init_unit_test_suite
+//
+test_suite* init_unit_test_suite( int argc, char* argv[] )
+{
+    test_suite *test = BOOST_TEST_SUITE("test moving regexes, results and iterators");
+    test->add(BOOST_TEST_CASE(&test_move_results));
+    test->add(BOOST_TEST_CASE(&test_move_regex));
+    test->add(BOOST_TEST_CASE(&test_move_iterators));
+    return test;
+}
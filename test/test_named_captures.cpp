@@ -0,0 +1,125 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_named_captures.cpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+//  Test looking up named captures by name and by number.
+
+#include <string>
+#include <sstream>
+#include <boost/xpressive/xpressive.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::unit_test;
+using namespace boost::xpressive;
+
+///////////////////////////////////////////////////////////////////////////////
+// test_many_names
+void test_many_names()
+{
+    // names that don't sort in the order they appear
+    std::string pattern, str;
+    for(int i = 30; i > 0; --i)
+    {
+        std::ostringstream name, value;
+        name << "f" << i;
+        value << i;
+        pattern += "(?P<" + name.str() + ">\\d+) ";
+        str += value.str() + " ";
+    }
+    sregex rx = sregex::compile(pattern);
+    BOOST_CHECK_EQUAL(rx.mark_count(), 30u);
+
+    smatch what;
+    BOOST_REQUIRE(regex_match(str, what, rx));
+    for(int i = 1; i <= 30; ++i)
+    {
+        std::ostringstream name, value;
+        name << "f" << i;
+        value << i;
+        std::size_t nbr = rx.mark_number(name.str());
+        BOOST_CHECK_EQUAL(nbr, static_cast<std::size_t>(31 - i));
+        BOOST_CHECK_EQUAL(rx.mark_number(name.str().c_str()), nbr);
+        BOOST_CHECK_EQUAL(what[nbr].str(), value.str());
+        BOOST_CHECK_EQUAL(what[name.str()].str(), value.str());
+        std::string fmt = "\\g<" + name.str() + ">";
+        BOOST_CHECK_EQUAL(regex_replace(str, rx, fmt, regex_constants::format_perl), value.str());
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_back_references
+void test_back_references()
+{
+    sregex rx = sregex::compile("(?P<b>.)(?P<a>.)(?P=a)(?P=b)");
+    std::string str("xabbay"), abc("abc");
+    smatch what;
+    BOOST_REQUIRE(regex_search(str, what, rx));
+    BOOST_CHECK_EQUAL(what.position(), 1);
+    BOOST_CHECK_EQUAL(what["a"].str(), "b");
+    BOOST_CHECK_EQUAL(rx.mark_number("b"), 1u);
+
+    // names that are prefixes of each other
+    sregex ab = sregex::compile("(?P<ab>a)(?P<a>b)(?P<abc>c)");
+    BOOST_REQUIRE(regex_search(abc, what, ab));
+    BOOST_CHECK_EQUAL(what["a"].str(), "b");
+    BOOST_CHECK_EQUAL(what["ab"].str(), "a");
+    BOOST_CHECK_EQUAL(what["abc"].str(), "c");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_errors
+void test_errors()
+{
+    BOOST_CHECK_THROW(sregex::compile("(?P<a>.)(?P<a>.)"), regex_error);
+    BOOST_CHECK_THROW(sregex::compile("(?P<a>.)(?P=b)"), regex_error);
+
+    sregex rx = sregex::compile("(?P<a>.)");
+    BOOST_CHECK_THROW(rx.mark_number("b"), regex_error);
+    BOOST_CHECK_THROW(sregex().mark_number("a"), regex_error);
+    BOOST_CHECK_THROW(sregex::compile(".").mark_number("a"), regex_error);
+
+    std::string str("x");
+    smatch what;
+    BOOST_REQUIRE(regex_match(str, what, rx));
+    BOOST_CHECK_THROW(what["b"], regex_error);
+    BOOST_CHECK_THROW(regex_replace(str, rx, std::string("\\g<b>"), regex_constants::format_perl), regex_error);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_copies
+void test_copies()
+{
+    // the names stay with the results when they are copied, and a named rule
+    // can be compiled again without disturbing them
+    sregex_compiler compiler;
+    sregex rx = compiler.compile("(?$rule=)(?P<a>x)(?P<b>y)");
+    std::string xy("xy"), yx("yx");
+    smatch what;
+    BOOST_REQUIRE(regex_match(xy, what, rx));
+    smatch copy(what);
+
+    compiler.compile("(?$rule=)(?P<b>y)(?P<a>x)");
+    BOOST_CHECK_EQUAL(copy["a"].str(), "x");
+    BOOST_CHECK_EQUAL(what["b"].str(), "y");
+
+    sregex rule = compiler["rule"];
+    BOOST_REQUIRE(regex_match(yx, what, rule));
+    BOOST_CHECK_EQUAL(what["a"].str(), "x");
+    BOOST_CHECK_EQUAL(rule.mark_number("a"), 2u);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// init_unit_test_suite
+//
+test_suite* init_unit_test_suite( int argc, char* argv[] )
+{
+    test_suite *test = BOOST_TEST_SUITE("test named captures");
+    test->add(BOOST_TEST_CASE(&test_many_names));
+    test->add(BOOST_TEST_CASE(&test_back_references));
+    test->add(BOOST_TEST_CASE(&test_errors));
+    test->add(BOOST_TEST_CASE(&test_copies));
+    return test;
+}
@@ -0,0 +1,142 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_nosubs.cpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+//  Test invoking nested regexes without creating nested results.
+
+#include <string>
+#include <boost/xpressive/xpressive.hpp>
+#include <boost/xpressive/regex_actions.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::unit_test;
+using namespace boost::xpressive;
+namespace xp = boost::xpressive;
+
+///////////////////////////////////////////////////////////////////////////////
+// test_static
+void test_static()
+{
+    std::string str("abc abc xyz xyz!");
+    smatch what;
+
+    // a rule with a back-reference of its own
+    sregex twice = (s1= +_w) >> ' ' >> s1;
+    sregex all = twice >> ' ' >> nosubs(twice) >> '!';
+    BOOST_REQUIRE(regex_match(str, what, all));
+    BOOST_REQUIRE_EQUAL(what.nested_results().size(), 1u);
+    BOOST_CHECK_EQUAL(what.nested_results().front()[1].str(), "abc");
+
+    // backtracking into a nested regex invoked without results
+    sregex word = +_w;
+    sregex two = nosubs(word) >> 'c' >> ' ' >> (s1= nosubs(word));
+    BOOST_REQUIRE(regex_search(str, what, two));
+    BOOST_CHECK_EQUAL(what[0].str(), "abc abc");
+    BOOST_CHECK_EQUAL(what[1].str(), "abc");
+    BOOST_CHECK(what.nested_results().empty());
+
+    // other modifiers keep the flag
+    sregex upper = icase(nosubs(word >> ' ' >> as_xpr("ABC")));
+    BOOST_REQUIRE(regex_search(str, what, upper));
+    BOOST_CHECK_EQUAL(what[0].str(), "abc abc");
+    BOOST_CHECK(what.nested_results().empty());
+
+    // rules invoked by a rule without results are added to the enclosing results
+    sregex pair = twice >> ' ' >> twice;
+    sregex outer = nosubs(pair);
+    BOOST_REQUIRE(regex_search(str, what, outer));
+    BOOST_REQUIRE_EQUAL(what.nested_results().size(), 2u);
+    BOOST_CHECK_EQUAL(what.nested_results().back()[1].str(), "xyz");
+    sregex inner = nosubs(twice >> ' ' >> twice);
+    BOOST_REQUIRE(regex_search(str, what, inner));
+    BOOST_CHECK(what.nested_results().empty());
+
+    // inside keep() and lookahead, where the sub-matches are saved and restored
+    sregex kept = keep(nosubs(twice)) >> ' ' >> ~before(nosubs(word) >> '?') >> nosubs(twice);
+    BOOST_REQUIRE(regex_search(str, what, kept));
+    BOOST_CHECK_EQUAL(what[0].str(), "abc abc xyz xyz");
+    BOOST_CHECK(what.nested_results().empty());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_recursive
+void test_recursive()
+{
+    std::string str("(a(b)(c(d)))");
+    smatch what;
+
+    sregex parens;
+    parens = '(' >> +(_w | by_ref(parens)) >> ')';
+    BOOST_REQUIRE(regex_match(str, what, parens));
+    BOOST_CHECK_EQUAL(what.nested_results().size(), 2u);
+
+    sregex light;
+    light = '(' >> +(_w | nosubs(by_ref(light))) >> ')';
+    BOOST_REQUIRE(regex_match(str, what, light));
+    BOOST_CHECK(what.nested_results().empty());
+    BOOST_CHECK(!regex_match(std::string("(a(b)"), what, light));
+
+    sregex self_light = '(' >> +(_w | nosubs(self)) >> ')';
+    BOOST_REQUIRE(regex_match(str, what, self_light));
+    BOOST_CHECK(what.nested_results().empty());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_actions
+void test_actions()
+{
+    std::string str("1+22+333");
+    int sum = 0;
+    smatch what;
+
+    sregex number = (s1= +_d)[ xp::ref(sum) += as<int>(s1) ];
+    sregex expr = number >> *('+' >> nosubs(number));
+    BOOST_REQUIRE(regex_match(str, what, expr));
+    BOOST_CHECK_EQUAL(sum, 356);
+    BOOST_CHECK_EQUAL(what.nested_results().size(), 1u);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_dynamic
+void test_dynamic()
+{
+    std::string str("foo 9*(10+3) bar");
+    smatch what;
+
+    for(int i = 0; i < 2; ++i)
+    {
+        regex_constants::syntax_option_type x = regex_constants::ignore_white_space;
+        if(1 == i)
+            x = x | regex_constants::nosubs;
+
+        sregex_compiler compiler;
+        compiler.compile( "(? $group  = ) \\( (? $expr ) \\) ", x);
+        compiler.compile( "(? $factor = ) \\d+ | (? $group ) ", x);
+        compiler.compile( "(? $term   = ) (? $factor ) (?: \\* (? $factor ) | / (? $factor ) )* ", x);
+        sregex expr = compiler.compile( "(? $expr   = ) (? $term )   (?: \\+ (? $term )   | - (? $term )   )* ", x);
+
+        BOOST_REQUIRE(regex_search(str, what, expr));
+        BOOST_CHECK_EQUAL(what[0].str(), "9*(10+3)");
+        BOOST_CHECK_EQUAL(what.nested_results().empty(), 1 == i);
+    }
+
+    sregex rx = sregex::compile("\\((?:\\w|(?R))+\\)", regex_constants::nosubs);
+    BOOST_REQUIRE(regex_match(std::string("(a(b)(c(d)))"), what, rx));
+    BOOST_CHECK(what.nested_results().empty());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// init_unit_test_suite
+//
+test_suite* init_unit_test_suite( int argc, char* argv[] )
+{
+    test_suite *test = BOOST_TEST_SUITE("test invoking nested regexes without nested results");
+    test->add(BOOST_TEST_CASE(&test_static));
+    test->add(BOOST_TEST_CASE(&test_recursive));
+    test->add(BOOST_TEST_CASE(&test_actions));
+    test->add(BOOST_TEST_CASE(&test_dynamic));
+    return test;
+}
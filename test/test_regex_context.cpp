@@ -0,0 +1,8 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_regex_context.cpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/xpressive/regex_context.hpp>
@@ -0,0 +1,138 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_sub_match_compare.cpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+//  Test comparing, hashing and viewing sub-matches without copying them.
+
+#include <list>
+#include <string>
+#include <boost/config.hpp>
+#include <boost/xpressive/xpressive.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::unit_test;
+using namespace boost::xpressive;
+
+int sign(int i)
+{
+    return (0 < i) - (i < 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_compare
+void test_compare()
+{
+    std::string str("abc=ab;abd=\xe9;x=");
+    sregex rx = sregex::compile("(\\w*)=([^;]*)(z)?");
+    std::vector<smatch> all;
+    for(sregex_iterator cur(str.begin(), str.end(), rx), end; cur != end; ++cur)
+        all.push_back(*cur);
+    BOOST_REQUIRE_EQUAL(all.size(), 3u);
+
+    // the results agree with std::string::compare
+    for(std::size_t i = 0; i < all.size(); ++i)
+    {
+        for(std::size_t j = 0; j < all.size(); ++j)
+        {
+            for(int a = 1; a <= 3; ++a)
+            {
+                for(int b = 1; b <= 3; ++b)
+                {
+                    ssub_match const &lhs = all[i][a], &rhs = all[j][b];
+                    int expected = sign(lhs.str().compare(rhs.str()));
+                    BOOST_CHECK_EQUAL(sign(lhs.compare(rhs)), expected);
+                    BOOST_CHECK_EQUAL(sign(lhs.compare(rhs.str())), expected);
+                    BOOST_CHECK_EQUAL(sign(lhs.compare(rhs.str().c_str())), expected);
+                    BOOST_CHECK_EQUAL(lhs < rhs, expected < 0);
+                    BOOST_CHECK_EQUAL(lhs == rhs, expected == 0);
+                }
+            }
+        }
+    }
+
+    ssub_match const &key = all[0][1], &value = all[0][2], &none = all[0][3];
+    BOOST_CHECK(key == "abc");
+    BOOST_CHECK("abc" == key);
+    BOOST_CHECK(key != "abcd");
+    BOOST_CHECK(key < "abd");
+    BOOST_CHECK("abd" > key);
+    BOOST_CHECK(key > "ab");
+    BOOST_CHECK("ab" <= key);
+    BOOST_CHECK(none == "");
+    BOOST_CHECK(none < "a");
+    BOOST_CHECK(value > none);
+
+    // characters compare as unsigned, like std::char_traits<char>
+    BOOST_CHECK(all[1][2] > "a");
+    BOOST_CHECK_EQUAL(sign(all[1][2].compare(std::string("a"))), sign(std::string("\xe9").compare("a")));
+
+    // single characters compare as one-character strings
+    BOOST_CHECK(all[2][1] == 'x');
+    BOOST_CHECK('x' == all[2][1]);
+    BOOST_CHECK(key > 'a');
+    BOOST_CHECK('b' > key);
+    BOOST_CHECK(none < 'a');
+
+    // non-contiguous sequences compare too
+    std::list<char> lst(str.begin(), str.end());
+    typedef std::list<char>::iterator list_iter;
+    match_results<list_iter> what;
+    BOOST_REQUIRE(regex_search(lst.begin(), lst.end(), what, basic_regex<list_iter>::compile("(\\w*)=([^;]*)")));
+    BOOST_CHECK(what[1] == "abc");
+    BOOST_CHECK(what[2] < "b");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_hash
+void test_hash()
+{
+    std::string str("key=value;k=");
+    smatch what;
+    BOOST_REQUIRE(regex_search(str, what, sregex::compile("(\\w+)=(\\w+)(z)?")));
+    boost::hash<std::string> string_hash;
+    boost::hash<ssub_match> sub_match_hash;
+    BOOST_CHECK_EQUAL(sub_match_hash(what[1]), string_hash("key"));
+    BOOST_CHECK_EQUAL(sub_match_hash(what[2]), string_hash("value"));
+    BOOST_CHECK_EQUAL(sub_match_hash(what[3]), string_hash(""));
+
+    // boost::hash comes with the xpressive headers, and so does hash_value()
+    BOOST_CHECK_EQUAL(hash_value(what[0]), string_hash("key=value"));
+    BOOST_CHECK_EQUAL(hash_value(what[0]), boost::hash_range(str.begin(), str.begin() + 9));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_view
+void test_view()
+{
+#ifndef BOOST_NO_CXX17_HDR_STRING_VIEW
+    std::string str("key=value;");
+    smatch what;
+    BOOST_REQUIRE(regex_search(str, what, sregex::compile("(\\w+)=(\\w*)(z)?")));
+    BOOST_CHECK(what[1].view() == "key");
+    BOOST_CHECK(what.view(2) == "value");
+    BOOST_CHECK(what.view() == "key=value");
+    BOOST_CHECK(what.view(3).empty());
+    BOOST_CHECK(what.view(2).data() == &str[4]);
+
+    char const *ptr = "a=";
+    cmatch cwhat;
+    BOOST_REQUIRE(regex_match(ptr, cwhat, cregex::compile("(\\w+)=(\\w*)")));
+    BOOST_CHECK(cwhat[1].view() == "a");
+    BOOST_CHECK(cwhat[2].view().empty());
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// init_unit_test_suite
+//
+test_suite* init_unit_test_suite( int argc, char* argv[] )
+{
+    test_suite *test = BOOST_TEST_SUITE("test comparing sub_match objects in place");
+    test->add(BOOST_TEST_CASE(&test_compare));
+    test->add(BOOST_TEST_CASE(&test_hash));
+    test->add(BOOST_TEST_CASE(&test_view));
+    return test;
+}
@@ -0,0 +1,111 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_sub_match_impl.cpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+//  Test that sub_match_impl stays small, and that searches over iterators
+//  whose sub-matches begin at an offset find what searches over strings do.
+
+#include <list>
+#include <deque>
+#include <string>
+#include <vector>
+#include <boost/static_assert.hpp>
+#include <boost/xpressive/xpressive.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::unit_test;
+using namespace boost::xpressive;
+
+typedef std::string::const_iterator string_iter;
+typedef std::list<char>::const_iterator list_iter;
+typedef std::deque<char>::const_iterator deque_iter;
+
+// where a sub-match began is an offset when that is smaller than the iterator
+BOOST_STATIC_ASSERT(sizeof(detail::sub_match_begin<deque_iter>) == sizeof(std::ptrdiff_t));
+BOOST_STATIC_ASSERT(sizeof(detail::sub_match_begin<list_iter>) == sizeof(list_iter));
+BOOST_STATIC_ASSERT(sizeof(detail::sub_match_impl<deque_iter>) < sizeof(sub_match<deque_iter>) + sizeof(deque_iter));
+
+#if defined(__GXX_ABI_VERSION)
+// where the tail padding of a base class is reused, zero_width_ and
+// repeat_count_ take no room of their own
+BOOST_STATIC_ASSERT(sizeof(detail::sub_match_impl<string_iter>) == sizeof(sub_match<string_iter>) + sizeof(string_iter));
+BOOST_STATIC_ASSERT(sizeof(detail::sub_match_impl<list_iter>) == sizeof(sub_match<list_iter>) + sizeof(list_iter));
+BOOST_STATIC_ASSERT(sizeof(detail::sub_match_impl<deque_iter>) == sizeof(sub_match<deque_iter>) + sizeof(std::ptrdiff_t));
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// matches
+//   the position and length of every sub-match of every match of pattern
+template<typename BidiIter>
+std::vector<std::ptrdiff_t> matches(BidiIter begin, BidiIter end, char const *pattern, regex_constants::match_flag_type flags)
+{
+    basic_regex<BidiIter> rx = basic_regex<BidiIter>::compile(pattern);
+    std::vector<std::ptrdiff_t> result;
+    regex_iterator<BidiIter> cur(begin, end, rx, flags), last;
+    for(; cur != last; ++cur)
+    {
+        for(std::size_t i = 0; i < cur->size(); ++i)
+        {
+            result.push_back((*cur)[i].matched ? cur->position(i) : -1);
+            result.push_back((*cur)[i].length());
+        }
+    }
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// check
+void check(std::string const &str, char const *pattern, regex_constants::match_flag_type flags = regex_constants::match_default)
+{
+    std::deque<char> deq(str.begin(), str.end());
+    std::vector<std::ptrdiff_t> expected = matches(str.begin(), str.end(), pattern, flags);
+    std::vector<std::ptrdiff_t> actual = matches(deq.begin(), deq.end(), pattern, flags);
+    BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), actual.begin(), actual.end());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_deque
+void test_deque()
+{
+    // long enough to span several of the deque's blocks
+    std::string str;
+    for(int i = 0; i < 200; ++i)
+    {
+        str += "ab12 cd, (x(y)z) aa  bb";
+    }
+
+    check(str, "(\\w+)\\s*(\\d*)");
+    check(str, "((a)|(b))+");
+    check(str, "(a*)*b");
+    check(str, "(?:(\\w)\\1)");
+    check(str, "\\((\\w(?:\\((\\w)\\))?\\w)\\)");
+    check(str, "(?=(\\w+))\\1,");
+    check(str, "(?<=(\\w\\w))\\d");
+    check(str, "(?>(a+))b*");
+    check(str, "x*");
+    check(str, "x*", regex_constants::match_not_null);
+    check(str, "(\\d)(?:(?R)|)");
+
+    // a partial match at the end of the input
+    std::deque<char> deq(str.begin(), str.end());
+    deq.push_back('c');
+    std::deque<char> const &cdeq = deq;
+    match_results<deque_iter> what;
+    basic_regex<deque_iter> rx = basic_regex<deque_iter>::compile("cdq");
+    BOOST_REQUIRE(regex_search(cdeq.begin(), cdeq.end(), what, rx, regex_constants::match_partial));
+    BOOST_CHECK(!what[0].matched);
+    BOOST_CHECK_EQUAL(std::distance(cdeq.begin(), what[0].first), static_cast<std::ptrdiff_t>(str.size()));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// init_unit_test_suite
+//
+test_suite* init_unit_test_suite( int argc, char* argv[] )
+{
+    test_suite *test = BOOST_TEST_SUITE("test sub_match_impl");
+    test->add(BOOST_TEST_CASE(&test_deque));
+    return test;
+}
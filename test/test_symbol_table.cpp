@@ -0,0 +1,233 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_symbol_table.cpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+//  Test that a regex sees the keys of a symbol_table<> that are replaced
+//  after the regex is built.
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/xpressive/xpressive_static.hpp>
+#include <boost/xpressive/regex_actions.hpp>
+#include <boost/test/unit_test.hpp>
+
+#if !defined(BOOST_DISABLE_THREADS) && !defined(BOOST_NO_CXX11_HDR_THREAD)
+# include <thread>
+# define TEST_THREADS
+#endif
+
+using namespace boost::unit_test;
+using namespace boost::xpressive;
+
+typedef std::map<std::string, std::string> string_map;
+
+///////////////////////////////////////////////////////////////////////////////
+// test_assign
+void test_assign()
+{
+    string_map map1, map2;
+    map1["foo"] = "1";
+    map1["bar"] = "2";
+    map2["baz"] = "3";
+
+    symbol_table<string_map> table(map1);
+    std::string result;
+    sregex rx = (a1=table)[ boost::xpressive::ref(result) = a1 ];
+
+    BOOST_CHECK(regex_match(std::string("foo"), rx));
+    BOOST_CHECK_EQUAL(result, "1");
+    BOOST_CHECK(!regex_match(std::string("baz"), rx));
+
+    // the regex sees the new keys, and so do copies of the table
+    symbol_table<string_map> copy(table);
+    copy.assign(map2);
+    BOOST_CHECK(!regex_match(std::string("foo"), rx));
+    BOOST_CHECK(regex_match(std::string("baz"), rx));
+    BOOST_CHECK_EQUAL(result, "3");
+    BOOST_CHECK(table.map() == map2);
+
+    // first characters the regex hasn't seen before are searched for, too
+    sregex srx = (a1=table)[ boost::xpressive::ref(result) = a1 ];
+    table.assign(map1);
+    BOOST_CHECK(regex_search(std::string("xx bar"), srx));
+    BOOST_CHECK_EQUAL(result, "2");
+    table.assign(map2);
+    BOOST_CHECK(regex_search(std::string("xx baz"), srx));
+    BOOST_CHECK_EQUAL(result, "3");
+
+    // a table with no keys matches nothing
+    symbol_table<string_map> empty;
+    sregex erx = (a1=empty)[ boost::xpressive::ref(result) = a1 ] | as_xpr("none");
+    BOOST_CHECK(!regex_match(std::string("foo"), erx));
+    BOOST_CHECK(regex_match(std::string("none"), erx));
+    BOOST_CHECK(empty.map().empty());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_icase
+void test_icase()
+{
+    std::map<std::string, int> map;
+    map["one"] = 1;
+    map["two"] = 2;
+
+    symbol_table<std::map<std::string, int> > table(map, regex_constants::icase);
+    int result = 0;
+    sregex rx = (a1=table)[ boost::xpressive::ref(result) = a1 ] >> '!';
+
+    BOOST_CHECK(regex_match(std::string("TWO!"), rx));
+    BOOST_CHECK_EQUAL(result, 2);
+
+    map["Three"] = 3;
+    table.assign(map);
+    BOOST_CHECK(regex_match(std::string("tHREE!"), rx));
+    BOOST_CHECK_EQUAL(result, 3);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// reassign
+//   an assertion that gives the table new keys in the middle of a match
+template<typename Map>
+struct reassign
+{
+    reassign(symbol_table<Map> &table, Map const &map)
+      : table_(&table)
+      , map_(&map)
+    {
+    }
+
+    bool operator()(ssub_match const &) const
+    {
+        this->table_->assign(*this->map_);
+        return true;
+    }
+
+    symbol_table<Map> *table_;
+    Map const *map_;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// test_keep
+//   the keys a search found stay alive until its actions have run, even when
+//   they were found in a keep(), and the rest of the search sees the same keys
+void test_keep()
+{
+    typedef std::map<std::string, int> int_map;
+    int_map map1, map2;
+    map1["foo"] = 1;
+    map2["bar"] = 2;
+
+    symbol_table<int_map> table(map1);
+    int result1 = 0, result2 = 0;
+
+    // the action reads the attribute after the keys it was found in are replaced
+    sregex krx = (keep(a1=table) >> nil[ check(reassign<int_map>(table, map2)) ])[ boost::xpressive::ref(result1) = a1 ];
+    BOOST_CHECK(regex_match(std::string("foo"), krx));
+    BOOST_CHECK_EQUAL(result1, 1);
+    table.assign(map1);
+
+    sregex rx = keep((a1=table)[ boost::xpressive::ref(result1) = a1 ])
+        >> nil[ check(reassign<int_map>(table, map2)) ]
+        >> ' ' >> (a1=table)[ boost::xpressive::ref(result2) = a1 ];
+
+    BOOST_CHECK(regex_match(std::string("foo foo"), rx));
+    BOOST_CHECK_EQUAL(result1, 1);
+    BOOST_CHECK_EQUAL(result2, 1);
+
+    // the next search sees the keys assigned during the last one
+    BOOST_CHECK(!regex_match(std::string("foo foo"), rx));
+    BOOST_CHECK(regex_match(std::string("bar bar"), rx));
+    BOOST_CHECK_EQUAL(result1, 2);
+    BOOST_CHECK_EQUAL(result2, 2);
+
+    // each step of an iterator is a search of its own
+    table.assign(map1);
+    sregex srx = (a1=table)[ boost::xpressive::ref(result1) = a1 ] >> nil[ check(reassign<int_map>(table, map2)) ];
+    std::string const str("foo bar foo");
+    sregex_iterator cur(str.begin(), str.end(), srx), end;
+    BOOST_REQUIRE(cur != end);
+    BOOST_CHECK_EQUAL(cur->position(), 0);
+    BOOST_CHECK_EQUAL(result1, 1);
+    BOOST_REQUIRE(++cur != end);
+    BOOST_CHECK_EQUAL(cur->position(), 4);
+    BOOST_CHECK_EQUAL(result1, 2);
+    BOOST_CHECK(++cur == end);
+}
+
+#ifdef TEST_THREADS
+///////////////////////////////////////////////////////////////////////////////
+// test_threads
+//   match while another thread replaces the keys
+void test_threads()
+{
+    string_map even, odd;
+    for(int i = 0; i < 100; ++i)
+    {
+        std::string key(1, char('a' + i % 26));
+        key += char('0' + i / 26);
+        (0 == i % 2 ? even : odd)[key] = key + key;
+    }
+
+    symbol_table<string_map> table(even);
+    std::thread writer([&]
+    {
+        for(int i = 0; i < 2000; ++i)
+        {
+            table.assign(0 == i % 2 ? odd : even);
+        }
+    });
+
+    std::vector<int> errors(3, 0);
+    std::vector<std::thread> readers;
+    for(std::size_t r = 0; r < errors.size(); ++r)
+    {
+        int *err = &errors[r];
+        readers.push_back(std::thread([&table, &even, &odd, err]
+        {
+            std::string result;
+            sregex rx = (a1=table)[ boost::xpressive::ref(result) = a1 ];
+            for(int i = 0; i < 20; ++i)
+            {
+                string_map const &keys = (0 == i % 2 ? even : odd);
+                for(string_map::const_iterator it = keys.begin(); it != keys.end(); ++it)
+                {
+                    // whichever map the key is found in, its value goes with it
+                    if(regex_match(it->first, rx) && result != it->second)
+                    {
+                        ++*err;
+                    }
+                }
+            }
+        }));
+    }
+
+    writer.join();
+    for(std::size_t r = 0; r < readers.size(); ++r)
+    {
+        readers[r].join();
+    }
+    for(std::size_t r = 0; r < errors.size(); ++r)
+    {
+        BOOST_CHECK_EQUAL(errors[r], 0);
+    }
+}
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// init_unit_test_suite
+//
+test_suite* init_unit_test_suite( int argc, char* argv[] )
+{
+    test_suite *test = BOOST_TEST_SUITE("test replaceable symbol tables");
+    test->add(BOOST_TEST_CASE(&test_assign));
+    test->add(BOOST_TEST_CASE(&test_icase));
+    test->add(BOOST_TEST_CASE(&test_keep));
+#ifdef TEST_THREADS
+    test->add(BOOST_TEST_CASE(&test_threads));
+#endif
+    return test;
+}
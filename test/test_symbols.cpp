@@ -332,6 +332,42 @@ void test9()
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// test10
+//  a large symbol table, searched repeatedly
+void test10()
+{
+    using namespace boost::xpressive;
+
+    std::map<std::string,int> map1;
+    for(int i = 0; i < 2000; ++i)
+    {
+        std::string key;
+        for(int j = i; j != 0 || key.empty(); j /= 10)
+        {
+            key.insert(key.begin(), char('0' + j % 10));
+        }
+        map1[key] = i;
+    }
+
+    int result = -1;
+    sregex rx = (a1=map1)[ xp::ref(result) = a1 ];
+    for(int pass = 0; pass < 3; ++pass)
+    {
+        std::map<std::string,int>::const_iterator it = map1.begin();
+        for(; it != map1.end(); ++it)
+        {
+            if(!regex_match(it->first, rx) || result != it->second)
+            {
+                BOOST_ERROR("oops");
+                return;
+            }
+        }
+    }
+    BOOST_CHECK(!regex_match(std::string("20000"), rx));
+    BOOST_CHECK(!regex_match(std::string("x"), rx));
+}
+
 using namespace boost::unit_test;
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -349,6 +385,7 @@ test_suite* init_unit_test_suite( int argc, char* argv[] )
     test->add(BOOST_TEST_CASE(&test7));
     test->add(BOOST_TEST_CASE(&test8));
     test->add(BOOST_TEST_CASE(&test9));
+    test->add(BOOST_TEST_CASE(&test10));
     return test;
 }
 
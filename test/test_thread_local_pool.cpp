@@ -0,0 +1,90 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_thread_local_pool.cpp
+//
+//  Copyright 2008 Eric Niebler. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+//  Test that fresh match_results objects reuse pooled memory on the same thread.
+
+#define BOOST_XPRESSIVE_USE_THREAD_LOCAL_POOL
+
+#include <new>
+#include <string>
+#include <cstdlib>
+#include <boost/xpressive/xpressive.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::unit_test;
+using namespace boost::xpressive;
+
+///////////////////////////////////////////////////////////////////////////////
+// count the allocations made through the global operator new
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t size)
+{
+    ++allocations;
+    if(void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) BOOST_NOEXCEPT_OR_NOTHROW
+{
+    std::free(p);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// test_fresh_results
+void test_fresh_results()
+{
+    sregex pair = (s1= +_w) >> '=' >> (s2= +_d);
+    sregex pairs = pair >> *(',' >> pair);
+    sregex many = sregex::compile("(a)(b)(c)(d)(e)(f)(g)(h)(i)(j)(k)(l)(m)(n)(o)(p)(q)(r)(s)(t)");
+    std::string str("a=1,bb=22,ccc=333"), abc("abcdefghijklmnopqrst");
+
+    // warm up
+    {
+        smatch what;
+        BOOST_REQUIRE(regex_match(str, what, pairs));
+        BOOST_REQUIRE(regex_match(abc, what, many));
+    }
+
+    for(int i = 0; i < 3; ++i)
+    {
+        std::size_t before = allocations;
+        {
+            smatch what;
+            BOOST_REQUIRE(regex_match(str, what, pairs));
+            BOOST_CHECK_EQUAL(what.nested_results().size(), 3u);
+            BOOST_CHECK_EQUAL(what.nested_results().back()[2].str(), "333");
+            BOOST_REQUIRE(regex_match(abc, what, many));
+            BOOST_CHECK_EQUAL(what[20].str(), "t");
+        }
+#ifdef BOOST_XPRESSIVE_HAS_THREAD_LOCAL_POOL
+        BOOST_CHECK_EQUAL(before, allocations);
+#endif
+    }
+
+    // several at once
+    {
+        smatch what1, what2, what3;
+        BOOST_REQUIRE(regex_match(str, what1, pairs));
+        BOOST_REQUIRE(regex_match(str, what2, pairs));
+        BOOST_REQUIRE(regex_match(abc, what3, many));
+        BOOST_CHECK_EQUAL(what1.nested_results().front()[1].str(), "a");
+        BOOST_CHECK_EQUAL(what2.nested_results().front()[2].str(), "1");
+        BOOST_CHECK_EQUAL(what3[1].str(), "a");
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// init_unit_test_suite
+//
+test_suite* init_unit_test_suite( int argc, char* argv[] )
+{
+    test_suite *test = BOOST_TEST_SUITE("test thread-local pooling of match_results memory");
+    test->add(BOOST_TEST_CASE(&test_fresh_results));
+    return test;
+}